@@ -0,0 +1,722 @@
+// NtripSoak: host-side soak test of the full client against a simulated
+// caster on the loopback interface.
+//
+// Usage: ntrip_soak [-n sessions] [-r bytesPerSec] [-T seconds] [-i seconds]
+//                   [-c maxChunk] [-k] [-x crcEveryN] [-p stallEverySec]
+//                   [-P stallMs] [-d dropEverySec] [-a authPct] [-m missingPct]
+//                   [-M] [-f] [-R ringSize] [-H healthMs] [-s seed] [-v]
+//                   [-L maxP99Ms] [-D minDeliveredPct] [-G maxHeapGrowthKB]
+//                   [-C maxReconnectMs] [capture.rtcm3]
+//
+// The caster serves every session its own paced stream: synthetic MSM7
+// (1077/1087/1097/1127 sized for the rate, 1005 every 40 frames) or the
+// frames of a capture file. Each frame large enough carries a stamp (magic,
+// sequence, send time) in its last payload bytes and is resealed, so the
+// sink can measure caster-to-Print latency per frame. Faults are optional:
+// random send chunking (-c), Transfer-Encoding: chunked (-k), one corrupted
+// frame in N (-x), stalls (-p/-P) and disconnects (-d) at exponential
+// intervals, and 401 / 404 answers to a share of requests (-a/-m).
+//
+// Every -i seconds a line reports throughput, latency percentiles, client
+// reconnects / CRC errors, heap in use and RSS. The summary at the end
+// checks the -L/-D/-G/-C limits and exits 1 if one is missed, so a run can
+// gate a change: compare against the same arguments on the parent commit.
+
+#include "NtripClient.h"
+#include "NtripSessionManager.h"
+#include "RtcmCorpus.h"
+
+#include <arpa/inet.h>
+#include <malloc.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#if NTRIP_CLIENT_ENABLE_TASK
+
+// ─── Options ────────────────────────────────────────────────────────────────
+
+struct SoakOptions {
+  uint32_t sessions = 4;
+  uint32_t rate = 4000;          // Bytes/s per session
+  uint32_t seconds = 30;
+  uint32_t interval = 5;
+  uint32_t maxChunk = 0;         // 0: whole frames per send()
+  bool chunked = false;          // Rev2 Transfer-Encoding: chunked
+  uint32_t crcEvery = 0;         // Corrupt one frame in N (0: never)
+  double stallEvery = 0;         // Mean seconds between stalls (0: never)
+  uint32_t stallMs = 2000;
+  double dropEvery = 0;          // Mean seconds between disconnects (0: never)
+  uint32_t authPct = 0;          // Requests answered 401
+  uint32_t missingPct = 0;       // Requests answered 404
+  bool manager = false;          // NtripSessionManager instead of one client per session
+  bool frameAligned = false;
+  uint32_t ringSize = 0;
+  uint32_t healthMs = 10000;
+  uint32_t seed = 1;
+  bool verbose = false;
+  double maxP99Ms = 0;           // Gates (0: not checked)
+  double minDeliveredPct = 0;
+  double maxHeapGrowthKB = 0;
+  double maxReconnectMs = 0;
+  const char* capture = nullptr;
+};
+
+static const auto START = std::chrono::steady_clock::now();
+
+// Microseconds since start; differences are wrap-safe in uint32_t.
+static uint32_t nowUs() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - START).count();
+}
+
+static void sleepMs(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+// Exponentially distributed delay with the given mean, in microseconds.
+static uint32_t expDelayUs(XorShift& rng, double meanSec) {
+  const double u = (rng.next() % 1000000 + 1) / 1000001.0;
+  return (uint32_t)min(-log(u) * meanSec * 1e6, 3.6e9);
+}
+
+// ─── Latency histogram ──────────────────────────────────────────────────────
+// Log-linear: exact below 16 µs, then 16 sub-buckets per power of two
+// (≤ 6.25 % error), so hours of samples fit in a fixed 3.7 KB.
+
+struct LatencyHist {
+  static constexpr int SUB = 16;
+  static constexpr int BUCKETS = 29 * SUB;
+
+  uint64_t counts[BUCKETS] = {};
+  uint64_t n = 0;
+  uint32_t maxUs = 0;
+
+  static int index(uint32_t us) {
+    if (us < (uint32_t)SUB) return (int)us;
+    const int k = 31 - __builtin_clz(us);
+    return (k - 3) * SUB + (int)((us >> (k - 4)) & (SUB - 1));
+  }
+  static uint32_t upper(int idx) {
+    if (idx < SUB) return (uint32_t)idx;
+    const int k = idx / SUB + 3;
+    return ((uint32_t)(SUB + idx % SUB + 1) << (k - 4)) - 1;
+  }
+
+  void record(uint32_t us) {
+    counts[index(us)]++;
+    n++;
+    if (us > maxUs) maxUs = us;
+  }
+  void merge(const LatencyHist& o) {
+    for (int i = 0; i < BUCKETS; i++) counts[i] += o.counts[i];
+    n += o.n;
+    if (o.maxUs > maxUs) maxUs = o.maxUs;
+  }
+  double percentileMs(double p) const {
+    if (n == 0) return 0;
+    const uint64_t target = (uint64_t)ceil(p * (double)n);
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+      seen += counts[i];
+      if (seen >= target) return min(upper(i), maxUs) / 1000.0;
+    }
+    return maxUs / 1000.0;
+  }
+};
+
+// ─── Frame source ───────────────────────────────────────────────────────────
+
+static constexpr uint32_t STAMP_MAGIC = 0x534F414Bu;  // "SOAK"
+static constexpr size_t STAMP_BYTES = 12;            // Magic, sequence, send time
+static constexpr size_t MIN_STAMPED_PAYLOAD = 40;    // Keeps the message header intact
+
+static bool collectFrame(const RtcmResult& frame, size_t end, void* ctx) {
+  auto* args = static_cast<std::pair<const uint8_t*, std::vector<std::vector<uint8_t>>*>*>(ctx);
+  if (!frame.valid) return true;
+  const uint8_t* start = args->first + end - (frame.length + RtcmParser::FRAME_OVERHEAD);
+  args->second->emplace_back(start, args->first + end);
+  return true;
+}
+
+// Template frames the caster cycles through; stamps are written into copies.
+static std::vector<std::vector<uint8_t>> makeTemplates(const SoakOptions& o) {
+  std::vector<std::vector<uint8_t>> frames;
+  if (o.capture != nullptr) {
+    Corpus c;
+    if (!loadCapture(o.capture, c)) return frames;
+    RtcmParser parser;
+    std::pair<const uint8_t*, std::vector<std::vector<uint8_t>>*> args(c.data.data(), &frames);
+    parser.feed(c.data.data(), c.data.size(), collectFrame, &args);
+    return frames;
+  }
+
+  // Four MSM frames per epoch at 1 Hz carry the rate.
+  static const uint16_t TYPES[] = {1077, 1087, 1097, 1127};
+  const uint32_t len = o.rate / 4 > RtcmParser::FRAME_OVERHEAD ? o.rate / 4 - RtcmParser::FRAME_OVERHEAD : 0;
+  const uint16_t payload = (uint16_t)max<uint32_t>(MIN_STAMPED_PAYLOAD + 64, min<uint32_t>(len, 1023));
+  XorShift rng(o.seed);
+  for (uint32_t i = 0; i < 400; i++) {
+    std::vector<uint8_t> f;
+    if (i % 40 == 0) appendFrame(f, 1005, 19, rng);
+    else appendFrame(f, TYPES[i % 4], payload, rng);
+    frames.push_back(std::move(f));
+  }
+  return frames;
+}
+
+static void stampFrame(std::vector<uint8_t>& f, uint32_t seq, uint32_t sentUs) {
+  uint8_t* stamp = f.data() + f.size() - 3 - STAMP_BYTES;
+  memcpy(stamp, &STAMP_MAGIC, 4);
+  memcpy(stamp + 4, &seq, 4);
+  memcpy(stamp + 8, &sentUs, 4);
+  resealFrame(f.data(), f.size());
+}
+
+static bool isStampable(const std::vector<uint8_t>& f) {
+  return f.size() >= RtcmParser::FRAME_OVERHEAD + MIN_STAMPED_PAYLOAD;
+}
+
+// ─── Per-session link between caster and sink ───────────────────────────────
+
+struct SessionLink {
+  std::atomic<uint32_t> nextSeq{1};
+  std::atomic<uint64_t> framesSent{0};     // Stamped, intact and fully sent
+  std::atomic<uint64_t> bytesSent{0};
+  std::atomic<uint32_t> connects{0};
+  std::atomic<uint32_t> rejects{0};
+  std::atomic<uint32_t> drops{0};
+  std::atomic<uint32_t> stalls{0};
+  std::atomic<uint32_t> corrupted{0};
+  // Set by a caster-side disconnect; the sink turns it into a reconnect time.
+  std::atomic<bool> dropPending{false};
+  std::atomic<uint32_t> dropSeq{0};
+  std::atomic<uint32_t> dropUs{0};
+};
+
+// ─── Sink ───────────────────────────────────────────────────────────────────
+// The client's Print: regroups the bytes into frames with its own parser and
+// records the stamp latency of each one.
+
+class SoakSink : public Print {
+public:
+  explicit SoakSink(SessionLink& l) : link(l) { pending.reserve(4096); }
+
+  size_t write(uint8_t b) override { return write(&b, 1); }
+
+  size_t write(const uint8_t* data, size_t len) override {
+    const size_t base = pending.size();
+    pending.insert(pending.end(), data, data + len);
+    chunkBase = pending.data() + base;
+    parser.feed(chunkBase, len, onFrame, this);
+    // Keep only the bytes of a frame still in progress.
+    const size_t keep = min(parser.pendingBytes(), pending.size());
+    pending.erase(pending.begin(), pending.end() - keep);
+    bytes.fetch_add(len, std::memory_order_relaxed);
+    return len;
+  }
+
+  // Interval snapshot: latency and reconnect samples since the last call.
+  void drain(LatencyHist& latency, LatencyHist& reconnect, uint64_t& frames, uint64_t& lost) {
+    std::lock_guard<std::mutex> lock(mutex);
+    latency.merge(intervalLatency);
+    reconnect.merge(intervalReconnect);
+    frames += intervalFrames;
+    lost += intervalLost;
+    intervalLatency = LatencyHist();
+    intervalReconnect = LatencyHist();
+    intervalFrames = 0;
+    intervalLost = 0;
+  }
+
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> stampedFrames{0};
+
+private:
+  static bool onFrame(const RtcmResult& frame, size_t end, void* ctx) {
+    static_cast<SoakSink*>(ctx)->frame(frame, end);
+    return true;
+  }
+
+  void frame(const RtcmResult& f, size_t end) {
+    if (!f.valid || f.length < MIN_STAMPED_PAYLOAD) return;
+    const uint8_t* stamp = chunkBase + end - 3 - STAMP_BYTES;
+    uint32_t magic, seq, sentUs;
+    memcpy(&magic, stamp, 4);
+    if (magic != STAMP_MAGIC) return;
+    memcpy(&seq, stamp + 4, 4);
+    memcpy(&sentUs, stamp + 8, 4);
+    const uint32_t now = nowUs();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    intervalLatency.record(now - sentUs);
+    intervalFrames++;
+    if (seq > lastSeq + 1 && lastSeq != 0) intervalLost += seq - lastSeq - 1;
+    if (seq > lastSeq) lastSeq = seq;
+    stampedFrames.fetch_add(1, std::memory_order_relaxed);
+    if (link.dropPending.load(std::memory_order_acquire) &&
+        seq >= link.dropSeq.load(std::memory_order_relaxed)) {
+      intervalReconnect.record(now - link.dropUs.load(std::memory_order_relaxed));
+      link.dropPending.store(false, std::memory_order_relaxed);
+    }
+  }
+
+  SessionLink& link;
+  RtcmParser parser;
+  std::vector<uint8_t> pending;
+  const uint8_t* chunkBase = nullptr;
+  uint32_t lastSeq = 0;
+
+  std::mutex mutex;
+  LatencyHist intervalLatency;
+  LatencyHist intervalReconnect;
+  uint64_t intervalFrames = 0;
+  uint64_t intervalLost = 0;
+};
+
+// ─── Simulated caster ───────────────────────────────────────────────────────
+
+class SimCaster {
+public:
+  SimCaster(const SoakOptions& o, const std::vector<std::vector<uint8_t>>& t, SessionLink* l)
+      : opt(o), templates(t), links(l) {}
+
+  bool start(uint16_t& port) {
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) return false;
+    const int one = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t alen = sizeof(addr);
+    if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenFd, 64) != 0 ||
+        getsockname(listenFd, (sockaddr*)&addr, &alen) != 0) {
+      close(listenFd);
+      return false;
+    }
+    port = ntohs(addr.sin_port);
+    acceptThread = std::thread(&SimCaster::acceptLoop, this);
+    return true;
+  }
+
+  void stop() {
+    stopping.store(true);
+    shutdown(listenFd, SHUT_RDWR);
+    acceptThread.join();
+    close(listenFd);
+    std::lock_guard<std::mutex> lock(mutex);
+    for (std::thread& t : workers) t.join();
+    workers.clear();
+  }
+
+private:
+  void acceptLoop() {
+    uint32_t connection = 0;
+    while (!stopping.load()) {
+      const int fd = accept(listenFd, nullptr, nullptr);
+      if (fd < 0) {
+        if (stopping.load()) break;
+        sleepMs(10);
+        continue;
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      workers.emplace_back(&SimCaster::serve, this, fd, ++connection);
+    }
+  }
+
+  bool sendAll(int fd, const uint8_t* data, size_t len) {
+    while (len > 0) {
+      const ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+      if (n <= 0) return false;
+      data += n;
+      len -= (size_t)n;
+    }
+    return true;
+  }
+
+  bool sendText(int fd, const char* s) { return sendAll(fd, (const uint8_t*)s, strlen(s)); }
+
+  // Send in random pieces of 1..maxChunk bytes, each as its own HTTP chunk
+  // when chunked encoding is on.
+  bool sendBody(int fd, const uint8_t* data, size_t len, bool chunked, XorShift& rng) {
+    while (len > 0) {
+      const size_t piece = opt.maxChunk > 0 ? min<size_t>(len, rng.range(1, opt.maxChunk)) : len;
+      if (chunked) {
+        char head[24];
+        snprintf(head, sizeof(head), "%zx\r\n", piece);
+        if (!sendText(fd, head) || !sendAll(fd, data, piece) || !sendText(fd, "\r\n")) return false;
+      } else if (!sendAll(fd, data, piece)) {
+        return false;
+      }
+      data += piece;
+      len -= piece;
+    }
+    return true;
+  }
+
+  void serve(int fd, uint32_t connection) {
+    const int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    timeval tv = {5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    char req[1024];
+    size_t got = 0;
+    while (got + 1 < sizeof(req)) {
+      const ssize_t n = recv(fd, req + got, sizeof(req) - 1 - got, 0);
+      if (n <= 0) break;
+      got += (size_t)n;
+      req[got] = '\0';
+      if (strstr(req, "\r\n\r\n") != nullptr) break;
+    }
+    req[got] = '\0';
+
+    const char* mount = strstr(req, "GET /SOAK");
+    const uint32_t index = mount != nullptr ? (uint32_t)atoi(mount + 9) : opt.sessions;
+    if (index >= opt.sessions) {
+      sendText(fd, "HTTP/1.1 404 Not Found\r\n\r\n");
+      close(fd);
+      return;
+    }
+    SessionLink& link = links[index];
+    const bool rev2 = strstr(req, "Ntrip-Version: Ntrip/2.0") != nullptr;
+    XorShift rng(opt.seed * 2654435761u ^ connection * 40503u);
+
+    const uint32_t roll = rng.next() % 100;
+    if (roll < opt.authPct + opt.missingPct) {
+      link.rejects.fetch_add(1);
+      sendText(fd, roll < opt.authPct
+                       ? (rev2 ? "HTTP/1.1 401 Unauthorized\r\n\r\n" : "HTTP/1.0 401 Unauthorized\r\n\r\n")
+                       : (rev2 ? "HTTP/1.1 404 Not Found\r\n\r\n" : "HTTP/1.0 404 Not Found\r\n\r\n"));
+      close(fd);
+      return;
+    }
+
+    const bool chunked = rev2 && opt.chunked;
+    const char* head = !rev2 ? "ICY 200 OK\r\n\r\n"
+                       : chunked ? "HTTP/1.1 200 OK\r\nNtrip-Version: Ntrip/2.0\r\n"
+                                   "Content-Type: gnss/data\r\nTransfer-Encoding: chunked\r\n\r\n"
+                                 : "HTTP/1.1 200 OK\r\nNtrip-Version: Ntrip/2.0\r\n"
+                                   "Content-Type: gnss/data\r\n\r\n";
+    if (!sendText(fd, head)) {
+      close(fd);
+      return;
+    }
+    link.connects.fetch_add(1);
+    stream(fd, link, chunked, rng);
+    close(fd);
+  }
+
+  // Paced body: a token bucket of opt.rate bytes/s, topped up every 5 ms.
+  void stream(int fd, SessionLink& link, bool chunked, XorShift& rng) {
+    size_t next = rng.next() % templates.size();
+    double budget = 0;
+    uint32_t last = nowUs();
+    uint32_t nextStall = opt.stallEvery > 0 ? last + expDelayUs(rng, opt.stallEvery) : 0;
+    uint32_t nextDrop = opt.dropEvery > 0 ? last + expDelayUs(rng, opt.dropEvery) : 0;
+    std::vector<uint8_t> frame;
+
+    while (!stopping.load(std::memory_order_relaxed)) {
+      uint32_t now = nowUs();
+      if (nextDrop != 0 && (int32_t)(now - nextDrop) >= 0) {
+        link.dropSeq.store(link.nextSeq.load());
+        link.dropUs.store(now);
+        link.dropPending.store(true, std::memory_order_release);
+        link.drops.fetch_add(1);
+        shutdown(fd, SHUT_RDWR);
+        return;
+      }
+      if (nextStall != 0 && (int32_t)(now - nextStall) >= 0) {
+        link.stalls.fetch_add(1);
+        for (uint32_t waited = 0; waited < opt.stallMs && !stopping.load(); waited += 10) sleepMs(10);
+        now = nowUs();
+        last = now;  // Data is not caught up after a stall
+        nextStall = now + expDelayUs(rng, opt.stallEvery);
+      }
+
+      budget = min(budget + (double)opt.rate * (uint32_t)(now - last) / 1e6, max((double)opt.rate, 2048.0));
+      last = now;
+      while (budget >= templates[next].size()) {
+        frame = templates[next];
+        next = (next + 1) % templates.size();
+        budget -= frame.size();
+        const bool stamped = isStampable(frame);
+        uint32_t seq = 0;
+        if (stamped) {
+          seq = link.nextSeq.fetch_add(1);
+          stampFrame(frame, seq, nowUs());
+        }
+        bool intact = true;
+        if (opt.crcEvery > 0 && rng.next() % opt.crcEvery == 0) {
+          frame[3 + rng.next() % (frame.size() - 6)] ^= (uint8_t)(1u << (rng.next() % 8));
+          link.corrupted.fetch_add(1);
+          intact = false;
+        }
+        if (!sendBody(fd, frame.data(), frame.size(), chunked, rng)) return;
+        link.bytesSent.fetch_add(frame.size(), std::memory_order_relaxed);
+        if (stamped && intact) link.framesSent.fetch_add(1, std::memory_order_relaxed);
+      }
+      sleepMs(5);
+    }
+  }
+
+  const SoakOptions& opt;
+  const std::vector<std::vector<uint8_t>>& templates;
+  SessionLink* links;
+  int listenFd = -1;
+  std::atomic<bool> stopping{false};
+  std::thread acceptThread;
+  std::mutex mutex;
+  std::vector<std::thread> workers;
+};
+
+// ─── Process memory ─────────────────────────────────────────────────────────
+
+static double heapKB() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  return mallinfo2().uordblks / 1024.0;
+#else
+  return 0;
+#endif
+}
+
+static double rssKB() {
+  FILE* f = fopen("/proc/self/statm", "r");
+  if (f == nullptr) return 0;
+  unsigned long size = 0, resident = 0;
+  const int n = fscanf(f, "%lu %lu", &size, &resident);
+  fclose(f);
+  return n == 2 ? resident * (sysconf(_SC_PAGESIZE) / 1024.0) : 0;
+}
+
+// ─── Driver ─────────────────────────────────────────────────────────────────
+
+static void logLine(NtripLogLevel level, const char* tag, const char* message) {
+  printf("  [%s] %d %s\n", tag, (int)level, message);
+}
+
+static bool parseArgs(int argc, char** argv, SoakOptions& o) {
+  for (int i = 1; i < argc; i++) {
+    const char* a = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (strcmp(a, "-k") == 0) o.chunked = true;
+    else if (strcmp(a, "-M") == 0) o.manager = true;
+    else if (strcmp(a, "-f") == 0) o.frameAligned = true;
+    else if (strcmp(a, "-v") == 0) o.verbose = true;
+    else if (a[0] == '-' && a[1] != '\0' && a[2] == '\0' && hasValue) {
+      const char* v = argv[++i];
+      switch (a[1]) {
+        case 'n': o.sessions = (uint32_t)atoi(v); break;
+        case 'r': o.rate = (uint32_t)atoi(v); break;
+        case 'T': o.seconds = (uint32_t)atoi(v); break;
+        case 'i': o.interval = (uint32_t)atoi(v); break;
+        case 'c': o.maxChunk = (uint32_t)atoi(v); break;
+        case 'x': o.crcEvery = (uint32_t)atoi(v); break;
+        case 'p': o.stallEvery = atof(v); break;
+        case 'P': o.stallMs = (uint32_t)atoi(v); break;
+        case 'd': o.dropEvery = atof(v); break;
+        case 'a': o.authPct = (uint32_t)atoi(v); break;
+        case 'm': o.missingPct = (uint32_t)atoi(v); break;
+        case 'R': o.ringSize = (uint32_t)atoi(v); break;
+        case 'H': o.healthMs = (uint32_t)atoi(v); break;
+        case 's': o.seed = (uint32_t)atoi(v); break;
+        case 'L': o.maxP99Ms = atof(v); break;
+        case 'D': o.minDeliveredPct = atof(v); break;
+        case 'G': o.maxHeapGrowthKB = atof(v); break;
+        case 'C': o.maxReconnectMs = atof(v); break;
+        default: return false;
+      }
+    } else if (a[0] != '-' && o.capture == nullptr) {
+      o.capture = a;
+    } else {
+      return false;
+    }
+  }
+  return o.sessions > 0 && o.rate > 0 && o.seconds > 0 && o.interval > 0 &&
+         o.authPct + o.missingPct < 100;
+}
+
+static NtripClientConfig sessionConfig(const SoakOptions& o, uint16_t port, uint32_t index) {
+  NtripClientConfig cfg;
+  cfg.host = "127.0.0.1";
+  cfg.port = port;
+  char mount[16];
+  snprintf(mount, sizeof(mount), "SOAK%u", (unsigned)index);
+  cfg.mount = mount;
+  cfg.user = "soak";
+  cfg.pass = "soak";
+  cfg.maxTries = 255;
+  cfg.retryPolicy = NtripRetryPolicy::BACKOFF;
+  cfg.retryBaseDelayMs = 250;
+  cfg.retryMaxDelayMs = 4000;
+  cfg.fastFirstRetry = true;
+  cfg.healthTimeoutMs = o.healthMs;
+  cfg.passiveSampleMs = min<uint32_t>(o.healthMs / 2, 5000);
+  if (o.frameAligned) {
+    cfg.frameAlignedOutput = true;
+    cfg.bufferSize = 2048;
+  }
+  cfg.outputRingSize = o.ringSize;
+  return cfg;
+}
+
+int main(int argc, char** argv) {
+  SoakOptions opt;
+  if (!parseArgs(argc, argv, opt)) {
+    fprintf(stderr, "usage: see the header of bench/host/NtripSoak.cpp\n");
+    return 2;
+  }
+
+  const std::vector<std::vector<uint8_t>> templates = makeTemplates(opt);
+  if (templates.empty()) {
+    fprintf(stderr, "no RTCM frames to serve\n");
+    return 2;
+  }
+
+  std::unique_ptr<SessionLink[]> links(new SessionLink[opt.sessions]);
+  std::vector<std::unique_ptr<SoakSink>> sinks;
+  for (uint32_t i = 0; i < opt.sessions; i++) sinks.emplace_back(new SoakSink(links[i]));
+
+  SimCaster caster(opt, templates, links.get());
+  uint16_t port = 0;
+  if (!caster.start(port)) {
+    fprintf(stderr, "caster: cannot listen on loopback\n");
+    return 2;
+  }
+
+  std::vector<std::unique_ptr<NtripClient>> clients;
+  NtripSessionManager manager;
+  bool started = true;
+  if (opt.manager) {
+    if (opt.verbose) manager.setLogger(logLine);
+    for (uint32_t i = 0; i < opt.sessions; i++)
+      started = started && manager.addSession(sessionConfig(opt, port, i), *sinks[i]) >= 0;
+    started = started && manager.start(0, true);
+  } else {
+    for (uint32_t i = 0; i < opt.sessions; i++) {
+      clients.emplace_back(new NtripClient());
+      NtripClient& c = *clients.back();
+      if (opt.verbose) c.setLogger(logLine);
+      started = started && c.begin(sessionConfig(opt, port, i), *sinks[i]) && c.startTask((uint8_t)(i & 1));
+    }
+  }
+  if (!started) {
+    fprintf(stderr, "client setup failed (check -n against NTRIP_SESSION_MAX_SESSIONS and the options)\n");
+    caster.stop();
+    return 2;
+  }
+
+  printf("ntrip_soak: %u session(s) %s, %u B/s each, %u s, port %u, %zu template frames%s\n",
+         (unsigned)opt.sessions, opt.manager ? "(manager)" : "(tasks)", (unsigned)opt.rate,
+         (unsigned)opt.seconds, (unsigned)port, templates.size(), opt.capture != nullptr ? " (capture)" : "");
+  printf("%7s %10s %8s %8s %8s %8s %8s %6s %6s %9s %9s\n", "t[s]", "kB/s", "frames/s", "p50[ms]", "p90[ms]",
+         "p99[ms]", "max[ms]", "reconn", "crcErr", "heap[kB]", "rss[kB]");
+
+  auto statsOf = [&](uint32_t i) { return opt.manager ? manager.getStats((uint8_t)i) : clients[i]->getStats(); };
+
+  LatencyHist totalLatency, totalReconnect;
+  uint64_t totalFrames = 0, totalLost = 0, lastBytes = 0;
+  double baseHeap = 0, baseRss = 0, heap = 0, rss = 0;
+  uint32_t clientReconnects = 0, clientCrc = 0;
+  const auto begin = std::chrono::steady_clock::now();
+
+  for (uint32_t elapsed = opt.interval; elapsed <= opt.seconds; elapsed += opt.interval) {
+    std::this_thread::sleep_until(begin + std::chrono::seconds(elapsed));
+    LatencyHist latency, reconnect;
+    uint64_t frames = 0, lost = 0, bytes = 0;
+    clientReconnects = 0;
+    clientCrc = 0;
+    for (uint32_t i = 0; i < opt.sessions; i++) {
+      sinks[i]->drain(latency, reconnect, frames, lost);
+      bytes += sinks[i]->bytes.load();
+      const NtripStats s = statsOf(i);
+      clientReconnects += s.reconnects;
+      clientCrc += s.crcErrors;
+    }
+    heap = heapKB();
+    rss = rssKB();
+    if (elapsed == opt.interval) {
+      baseHeap = heap;  // Growth is measured from the first interval (buffers are allocated by then)
+      baseRss = rss;
+    }
+    printf("%7u %10.1f %8.1f %8.2f %8.2f %8.2f %8.2f %6u %6u %9.0f %9.0f\n", (unsigned)elapsed,
+           (bytes - lastBytes) / 1024.0 / opt.interval, (double)frames / opt.interval,
+           latency.percentileMs(0.50), latency.percentileMs(0.90), latency.percentileMs(0.99),
+           latency.maxUs / 1000.0, (unsigned)clientReconnects, (unsigned)clientCrc, heap, rss);
+    fflush(stdout);
+    lastBytes = bytes;
+    totalLatency.merge(latency);
+    totalReconnect.merge(reconnect);
+    totalFrames += frames;
+    totalLost += lost;
+  }
+
+  // Stop the source first and let forwarded bytes settle before the
+  // clients go, then count what arrived after the last report.
+  caster.stop();
+  sleepMs(200);
+  if (opt.manager) manager.stop();
+  for (auto& c : clients) c->stopTask();
+  {
+    LatencyHist latency;
+    for (uint32_t i = 0; i < opt.sessions; i++) sinks[i]->drain(latency, totalReconnect, totalFrames, totalLost);
+    totalLatency.merge(latency);
+  }
+
+  // ── Summary ──
+  uint64_t sent = 0, sentBytes = 0;
+  uint32_t connects = 0, rejects = 0, drops = 0, stalls = 0, corrupted = 0;
+  for (uint32_t i = 0; i < opt.sessions; i++) {
+    sent += links[i].framesSent.load();
+    sentBytes += links[i].bytesSent.load();
+    connects += links[i].connects.load();
+    rejects += links[i].rejects.load();
+    drops += links[i].drops.load();
+    stalls += links[i].stalls.load();
+    corrupted += links[i].corrupted.load();
+  }
+  const double delivered = sent > 0 ? 100.0 * (double)min<uint64_t>(totalFrames, sent) / (double)sent : 0;
+  const double p99 = totalLatency.percentileMs(0.99);
+  const double reconnectMax = totalReconnect.maxUs / 1000.0;
+
+  printf("\ncaster : %u connects, %u rejected, %u dropped, %u stalls, %u corrupted, %.1f kB sent\n",
+         (unsigned)connects, (unsigned)rejects, (unsigned)drops, (unsigned)stalls, (unsigned)corrupted,
+         sentBytes / 1024.0);
+  printf("frames : %llu of %llu intact stamped frames delivered (%.2f %%), %llu sequence gaps\n",
+         (unsigned long long)totalFrames, (unsigned long long)sent, delivered, (unsigned long long)totalLost);
+  printf("latency: p50 %.2f  p90 %.2f  p99 %.2f  p99.9 %.2f  max %.2f ms\n", totalLatency.percentileMs(0.50),
+         totalLatency.percentileMs(0.90), p99, totalLatency.percentileMs(0.999), totalLatency.maxUs / 1000.0);
+  printf("reconn : %llu measured, p50 %.0f  max %.0f ms (caster drop to first stamped frame)\n",
+         (unsigned long long)totalReconnect.n, totalReconnect.percentileMs(0.50), reconnectMax);
+  printf("memory : heap %+.1f kB, rss %+.1f kB since the first interval\n", heap - baseHeap, rss - baseRss);
+
+  bool pass = true;
+  auto gate = [&](const char* what, bool ok, double value, double limit) {
+    printf("gate   : %-22s %10.2f (limit %g) %s\n", what, value, limit, ok ? "ok" : "FAIL");
+    pass = pass && ok;
+  };
+  if (opt.maxP99Ms > 0) gate("latency p99 [ms]", p99 <= opt.maxP99Ms, p99, opt.maxP99Ms);
+  if (opt.minDeliveredPct > 0) gate("delivered [%]", delivered >= opt.minDeliveredPct, delivered, opt.minDeliveredPct);
+  if (opt.maxHeapGrowthKB > 0)
+    gate("heap growth [kB]", heap - baseHeap <= opt.maxHeapGrowthKB, heap - baseHeap, opt.maxHeapGrowthKB);
+  if (opt.maxReconnectMs > 0) gate("reconnect max [ms]", reconnectMax <= opt.maxReconnectMs, reconnectMax, opt.maxReconnectMs);
+  printf("%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
+
+#else
+
+int main() {
+  fprintf(stderr, "ntrip_soak needs NTRIP_CLIENT_ENABLE_TASK=1\n");
+  return 2;
+}
+
+#endif  // NTRIP_CLIENT_ENABLE_TASK
@@ -0,0 +1,391 @@
+// RtcmBench: host-side throughput benchmark for RtcmParser and the
+// frame-aligned forwarding pipeline.
+//
+// Usage: rtcm_bench [-e epochs] [-b bufferSize] [-s seed] [-t seconds]
+//                   [-w dir] [capture.rtcm3 ...]
+//
+// Without capture files the built-in corpora are used: a deterministic
+// 1 Hz MSM7 stream (GPS/GLONASS/Galileo/BeiDou + 1230, 1005/1033 every
+// 10 s) and three damaged variants of it. -w writes them out so they can be
+// replayed elsewhere. Build once per CRC backend (see Makefile) and compare.
+
+#include "RtcmCorpus.h"
+#include "RtcmMessageFilter.h"
+#include "SpscRingBuffer.h"
+
+#include <stdlib.h>
+#include <chrono>
+
+// ─── Corpus generation ──────────────────────────────────────────────────────
+
+static Corpus makeClean(uint32_t epochs, uint32_t seed) {
+  struct Msg { uint16_t type; uint16_t minLen; uint16_t maxLen; };
+  static const Msg EPOCH[] = {
+    {1077, 300, 520}, {1087, 220, 400}, {1097, 260, 460}, {1127, 200, 420}, {1230, 8, 8},
+  };
+  static const Msg STATION[] = { {1005, 19, 19}, {1033, 24, 40} };
+
+  Corpus c;
+  c.name = "clean";
+  XorShift rng(seed);
+  for (uint32_t e = 0; e < epochs; e++) {
+    if (e % 10 == 0) {
+      for (const Msg& m : STATION) {
+        appendFrame(c.data, m.type, (uint16_t)rng.range(m.minLen, m.maxLen), rng);
+        c.frames++;
+      }
+    }
+    for (const Msg& m : EPOCH) {
+      appendFrame(c.data, m.type, (uint16_t)rng.range(m.minLen, m.maxLen), rng);
+      c.frames++;
+    }
+  }
+  return c;
+}
+
+// One random bit flipped roughly every `spacing` bytes.
+static Corpus makeBitflip(const Corpus& clean, uint32_t spacing, uint32_t seed) {
+  Corpus c;
+  c.name = "bitflip";
+  c.data = clean.data;
+  XorShift rng(seed);
+  for (size_t pos = rng.range(0, spacing); pos < c.data.size(); pos += rng.range(1, 2 * spacing)) {
+    c.data[pos] ^= (uint8_t)(1u << (rng.next() & 7));
+  }
+  return c;
+}
+
+// Noise bursts between frames, rich in false 0xD3 preambles (e.g. a caster
+// interleaving NMEA/binary junk, or a serial bridge losing sync).
+static Corpus makeGarbage(uint32_t epochs, uint32_t seed) {
+  Corpus clean = makeClean(epochs, seed);
+  Corpus c;
+  c.name = "garbage";
+  XorShift rng(seed ^ 0x9E3779B9u);
+  // Walk the clean stream frame by frame and inject a burst after ~1 in 4.
+  size_t pos = 0;
+  while (pos + 3 <= clean.data.size()) {
+    const size_t len = ((clean.data[pos + 1] & 0x03) << 8 | clean.data[pos + 2]) + RtcmParser::FRAME_OVERHEAD;
+    c.data.insert(c.data.end(), clean.data.begin() + pos, clean.data.begin() + pos + len);
+    pos += len;
+    if (rng.range(0, 3) == 0) {
+      const uint32_t burst = rng.range(16, 256);
+      for (uint32_t i = 0; i < burst; i++) {
+        c.data.push_back(rng.range(0, 15) == 0 ? 0xD3 : (uint8_t)rng.next());
+      }
+    }
+  }
+  c.frames = clean.frames;
+  return c;
+}
+
+// ~1 in 20 frames cut short, so the parser swallows the start of the next
+// frame and must resync.
+static Corpus makeTruncated(const Corpus& clean, uint32_t seed) {
+  Corpus c;
+  c.name = "truncated";
+  XorShift rng(seed);
+  size_t pos = 0;
+  while (pos + 3 <= clean.data.size()) {
+    const size_t len = ((clean.data[pos + 1] & 0x03) << 8 | clean.data[pos + 2]) + RtcmParser::FRAME_OVERHEAD;
+    const size_t keep = rng.range(0, 19) == 0 ? rng.range(3, (uint32_t)len - 1) : len;
+    c.data.insert(c.data.end(), clean.data.begin() + pos, clean.data.begin() + pos + keep);
+    if (keep == len) c.frames++;
+    pos += len;
+  }
+  return c;
+}
+
+static void writeCorpus(const std::string& dir, const Corpus& c) {
+  const std::string path = dir + "/" + c.name + ".rtcm3";
+  FILE* f = fopen(path.c_str(), "wb");
+  if (f == nullptr || fwrite(c.data.data(), 1, c.data.size(), f) != c.data.size()) {
+    fprintf(stderr, "cannot write %s\n", path.c_str());
+  }
+  if (f != nullptr) fclose(f);
+}
+
+// ─── Benchmarks ─────────────────────────────────────────────────────────────
+
+struct Counts {
+  uint32_t valid = 0;
+  uint32_t crcErrors = 0;
+  uint64_t forwarded = 0;  // Bytes reaching the sink (pipeline only)
+  uint32_t decoded = 0;    // MSM headers / ARPs decoded (decode only)
+};
+
+// Per-byte API, as used by the original polling loop.
+static Counts runBytewise(const Corpus& c) {
+  RtcmParser parser;
+  Counts k;
+  for (uint8_t b : c.data) {
+    const RtcmResult r = parser.feed(b);
+    if (r.valid) k.valid++;
+    if (r.crcError) k.crcErrors++;
+  }
+  return k;
+}
+
+static bool countFrame(const RtcmResult& frame, size_t, void* arg) {
+  Counts& k = *static_cast<Counts*>(arg);
+  if (frame.crcError) k.crcErrors++;
+  else k.valid++;
+  return true;
+}
+
+// Bulk API over socket-sized reads.
+static Counts runBulk(const Corpus& c, size_t bufferSize) {
+  RtcmParser parser;
+  Counts k;
+  for (size_t pos = 0; pos < c.data.size(); pos += bufferSize) {
+    parser.feed(c.data.data() + pos, std::min(bufferSize, c.data.size() - pos), countFrame, &k);
+  }
+  return k;
+}
+
+// Bulk API plus what a fleet-monitoring frame inspector typically reads:
+// station ID, MSM header (epoch, masks, counts) or the 1005/1006 ARP.
+struct DecodeRun {
+  const uint8_t* base = nullptr;  // Start of the chunk being fed
+  uint64_t sink = 0;              // Folded results, keeps the decode live
+  Counts k;
+};
+
+static bool decodeFrame(const RtcmResult& frame, size_t end, void* arg) {
+  DecodeRun& d = *static_cast<DecodeRun*>(arg);
+  if (frame.crcError) {
+    d.k.crcErrors++;
+    return true;
+  }
+  d.k.valid++;
+  const size_t len = frame.length + RtcmParser::FRAME_OVERHEAD;
+  const RtcmFrame f(d.base + end - len, len);  // Corpus is contiguous across chunks
+  uint16_t station;
+  RtcmMsmHeader msm;
+  RtcmStationArp arp;
+  if (f.stationId(station)) d.sink += station;
+  if (f.msmHeader(msm)) {
+    d.sink += msm.epochTime + msm.cells;
+    d.k.decoded++;
+  } else if (f.stationArp(arp)) {
+    d.sink += (uint64_t)arp.ecefX;
+    d.k.decoded++;
+  }
+  return true;
+}
+
+static volatile uint64_t decodeSink;
+
+static Counts runDecode(const Corpus& c, size_t bufferSize) {
+  RtcmParser parser;
+  DecodeRun d;
+  for (size_t pos = 0; pos < c.data.size(); pos += bufferSize) {
+    d.base = c.data.data() + pos;
+    parser.feed(d.base, std::min(bufferSize, c.data.size() - pos), decodeFrame, &d);
+  }
+  decodeSink = d.sink;
+  return d.k;
+}
+
+// Mirror of NtripClient::forwardFrameAligned(): reads land behind the carried
+// partial frame, adjacent accepted frames coalesce into one span, the filter
+// breaks spans, and spans go to the sink directly or through the SPSC ring.
+struct Pipeline {
+  RtcmMessageFilter* filter = nullptr;
+  SpscRingBuffer* ring = nullptr;
+  uint8_t* buffer = nullptr;
+  size_t feedOffset = 0;
+  size_t spanStart = 0;
+  size_t spanEnd = 0;
+  unsigned long now = 0;
+  Counts k;
+
+  void emit(const uint8_t* data, size_t len) {
+    if (len == 0) return;
+    if (ring != nullptr) {
+      // Single-threaded stand-in for the writer task: drain when full.
+      while (!ring->push(data, len)) drain();
+    } else {
+      sink(data, len);
+    }
+  }
+
+  void drain() {
+    const uint8_t* out;
+    size_t n;
+    while ((n = ring->peek(out)) > 0) {
+      sink(out, n);
+      ring->consume(n);
+    }
+  }
+
+  void sink(const uint8_t* data, size_t len) {
+    // Touch the bytes so the copy cannot be elided.
+    k.forwarded += len + (data[len - 1] & 0);
+  }
+};
+
+static bool pipelineFrame(const RtcmResult& frame, size_t endOffset, void* arg) {
+  Pipeline& p = *static_cast<Pipeline*>(arg);
+  if (frame.crcError) {
+    p.k.crcErrors++;
+    return true;
+  }
+  p.k.valid++;
+  const size_t end = p.feedOffset + endOffset;
+  const size_t start = end - (frame.length + RtcmParser::FRAME_OVERHEAD);
+  if (!p.filter->accept(frame.messageType, p.now)) {
+    // Filtered frame breaks the span.
+  } else if (start != p.spanEnd) {
+    p.emit(p.buffer + p.spanStart, p.spanEnd - p.spanStart);
+    p.spanStart = start;
+    p.spanEnd = end;
+  } else {
+    p.spanEnd = end;
+  }
+  return true;
+}
+
+static Counts runPipeline(const Corpus& c, size_t bufferSize, RtcmMessageFilter& filter,
+                          SpscRingBuffer* ring) {
+  std::vector<uint8_t> buffer(bufferSize);
+  RtcmParser parser;
+  Pipeline p;
+  p.filter = &filter;
+  p.ring = ring;
+  p.buffer = buffer.data();
+  filter.resetTiming();
+  if (ring != nullptr) ring->clear();
+
+  size_t carry = 0;
+  size_t pos = 0;
+  while (pos < c.data.size()) {
+    const size_t n = std::min(bufferSize - carry, c.data.size() - pos);
+    memcpy(buffer.data() + carry, c.data.data() + pos, n);  // Stands in for recv()
+    pos += n;
+
+    p.feedOffset = carry;
+    p.spanStart = p.spanEnd = 0;
+    p.now = (unsigned long)(pos / 2000 * 1000);  // ~2 KB/s stream clock for decimation
+    parser.feed(buffer.data() + carry, n, pipelineFrame, &p);
+    p.emit(buffer.data() + p.spanStart, p.spanEnd - p.spanStart);
+
+    const size_t total = carry + n;
+    const size_t pending = parser.pendingBytes();
+    if (pending > 0 && pending < total) memmove(buffer.data(), buffer.data() + total - pending, pending);
+    carry = pending;
+  }
+  if (ring != nullptr) p.drain();
+  return p.k;
+}
+
+// ─── Reporting ──────────────────────────────────────────────────────────────
+
+template <typename Fn>
+static void measure(const Corpus& c, const char* mode, double minSeconds, Fn fn) {
+  using clock = std::chrono::steady_clock;
+  Counts k;
+  uint32_t runs = 0;
+  const clock::time_point t0 = clock::now();
+  double elapsed = 0;
+  do {
+    k = fn();
+    runs++;
+    elapsed = std::chrono::duration<double>(clock::now() - t0).count();
+  } while (elapsed < minSeconds);
+
+  const double bytes = (double)c.data.size() * runs;
+  printf("%-14s %-18s %9.1f %8.2f %11.0f %8u %7u %10llu %8u\n",
+         c.name.c_str(), mode,
+         bytes / elapsed / 1e6,
+         elapsed * 1e9 / bytes,
+         (double)k.valid * runs / elapsed,
+         k.valid, k.crcErrors,
+         (unsigned long long)k.forwarded, k.decoded);
+}
+
+static const char* backendName() {
+#if NTRIP_CLIENT_CRC24Q_BACKEND == NTRIP_CLIENT_CRC24Q_BITWISE
+  return "bitwise";
+#elif NTRIP_CLIENT_CRC24Q_BACKEND == NTRIP_CLIENT_CRC24Q_SLICE4
+  return "slice4";
+#else
+  return "table";
+#endif
+}
+
+static void usage() {
+  fprintf(stderr, "usage: rtcm_bench [-e epochs] [-b bufferSize] [-s seed] [-t seconds] "
+                  "[-w dir] [capture.rtcm3 ...]\n");
+  exit(2);
+}
+
+int main(int argc, char** argv) {
+  uint32_t epochs = 3600;
+  size_t bufferSize = 2048;
+  uint32_t seed = 1;
+  double minSeconds = 0.3;
+  const char* dumpDir = nullptr;
+  std::vector<Corpus> corpora;
+
+  for (int i = 1; i < argc; i++) {
+    const bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "-e") == 0 && hasValue) epochs = (uint32_t)atoi(argv[++i]);
+    else if (strcmp(argv[i], "-b") == 0 && hasValue) bufferSize = (size_t)atoi(argv[++i]);
+    else if (strcmp(argv[i], "-s") == 0 && hasValue) seed = (uint32_t)atoi(argv[++i]);
+    else if (strcmp(argv[i], "-t") == 0 && hasValue) minSeconds = atof(argv[++i]);
+    else if (strcmp(argv[i], "-w") == 0 && hasValue) dumpDir = argv[++i];
+    else if (argv[i][0] == '-') usage();
+    else {
+      Corpus c;
+      if (!loadCapture(argv[i], c)) {
+        fprintf(stderr, "cannot read %s\n", argv[i]);
+        return 1;
+      }
+      corpora.push_back(c);
+    }
+  }
+  // Same floor NtripClient::begin() enforces for frameAlignedOutput.
+  if (bufferSize < RtcmParser::MAX_FRAME_SIZE) {
+    fprintf(stderr, "bufferSize must be at least %u\n", (unsigned)RtcmParser::MAX_FRAME_SIZE);
+    return 2;
+  }
+
+  if (corpora.empty()) {
+    const Corpus clean = makeClean(epochs, seed);
+    corpora.push_back(clean);
+    corpora.push_back(makeBitflip(clean, 4096, seed + 1));
+    corpora.push_back(makeGarbage(epochs, seed));
+    corpora.push_back(makeTruncated(clean, seed + 2));
+  }
+  if (dumpDir != nullptr) {
+    for (const Corpus& c : corpora) writeCorpus(dumpDir, c);
+  }
+
+  // Typical rover profile: drop 1033, forward 1005 once per 10 s.
+  RtcmMessageFilter filter;
+  filter.deny(1033);
+  filter.setInterval(1005, 10000);
+  RtcmMessageFilter passAll;
+
+  // Ring must hold the largest span (one full buffer).
+  size_t ringSize = 4096;
+  while (ringSize < bufferSize) ringSize <<= 1;
+  std::vector<uint8_t> ringStorage(ringSize);
+  SpscRingBuffer ring;
+  ring.begin(ringStorage.data(), ringStorage.size());
+
+  printf("CRC24Q backend: %s, bufferSize %u\n\n", backendName(), (unsigned)bufferSize);
+  printf("%-14s %-18s %9s %8s %11s %8s %7s %10s %8s\n",
+         "corpus", "mode", "MB/s", "ns/byte", "frames/s", "valid", "crcErr", "forwarded", "decoded");
+  for (const Corpus& c : corpora) {
+    measure(c, "feed(byte)", minSeconds, [&] { return runBytewise(c); });
+    measure(c, "feed(bulk)", minSeconds, [&] { return runBulk(c, bufferSize); });
+    measure(c, "feed(bulk)+decode", minSeconds, [&] { return runDecode(c, bufferSize); });
+    measure(c, "pipeline", minSeconds, [&] { return runPipeline(c, bufferSize, passAll, nullptr); });
+    measure(c, "pipeline+filter", minSeconds, [&] { return runPipeline(c, bufferSize, filter, nullptr); });
+    measure(c, "pipeline+ring", minSeconds, [&] { return runPipeline(c, bufferSize, filter, &ring); });
+    if (c.frames > 0) printf("%-14s %u frames generated intact\n", "", c.frames);
+  }
+  return 0;
+}
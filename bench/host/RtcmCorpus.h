@@ -0,0 +1,94 @@
+#pragma once
+// RtcmCorpus: synthetic RTCM frames and capture loading shared by the host
+// benchmarks (rtcm_bench, ntrip_soak).
+
+#include "RtcmParser.h"
+#include "RtcmFrame.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+struct Corpus {
+  std::string name;
+  std::vector<uint8_t> data;
+  uint32_t frames = 0;  // Intact frames as generated (0 for captures)
+};
+
+class XorShift {
+public:
+  explicit XorShift(uint32_t seed) : state(seed != 0 ? seed : 1) {}
+  uint32_t next() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+  uint32_t range(uint32_t lo, uint32_t hi) { return lo + next() % (hi - lo + 1); }
+
+private:
+  uint32_t state;
+};
+
+// MSB-first bit field store, the inverse of RtcmBitReader.
+static inline void putBits(uint8_t* p, size_t pos, uint8_t count, uint64_t v) {
+  for (uint8_t i = 0; i < count; i++, pos++) {
+    const uint8_t mask = (uint8_t)(0x80 >> (pos & 7));
+    if ((v >> (count - 1 - i)) & 1) p[pos >> 3] |= mask;
+    else p[pos >> 3] &= (uint8_t)~mask;
+  }
+}
+
+// Plausible headers so RtcmFrame decoding follows the real code paths;
+// everything after the header stays random.
+static inline void writeHeader(uint8_t* payload, uint16_t type, uint16_t stationId, XorShift& rng) {
+  putBits(payload, 0, 12, type);
+  putBits(payload, 12, 12, stationId);
+  if (type == 1005) {
+    putBits(payload, 34, 38, (uint64_t)40755803000LL);  // ARP ECEF, 0.1 mm
+    putBits(payload, 74, 38, (uint64_t)-1573456000LL);
+    putBits(payload, 114, 38, (uint64_t)48977800000LL);
+  } else if (type >= 1071 && type <= 1137) {
+    putBits(payload, RtcmFrame::MSM_EPOCH_POS, 30, rng.next() % 604800000u);
+    uint64_t sats = 0;
+    const uint32_t count = rng.range(6, 12);
+    while ((uint32_t)__builtin_popcountll(sats) < count) sats |= 1ULL << rng.range(0, 63);
+    putBits(payload, RtcmFrame::MSM_SAT_MASK_POS, 64, sats);
+    putBits(payload, RtcmFrame::MSM_SIG_MASK_POS, 32, 0x80080000u);  // Two signals
+    putBits(payload, RtcmFrame::MSM_CELL_MASK_POS, (uint8_t)(count * 2), ~0ULL);
+  }
+}
+
+static inline void appendFrame(std::vector<uint8_t>& out, uint16_t type, uint16_t len, XorShift& rng) {
+  const size_t start = out.size();
+  out.push_back(0xD3);
+  out.push_back((uint8_t)(len >> 8));
+  out.push_back((uint8_t)len);
+  for (uint16_t i = 0; i < len; i++) out.push_back((uint8_t)rng.next());
+  writeHeader(out.data() + start + 3, type, 2003, rng);
+  const uint32_t crc = RtcmParser::crc24q(out.data() + start, out.size() - start);
+  out.push_back((uint8_t)(crc >> 16));
+  out.push_back((uint8_t)(crc >> 8));
+  out.push_back((uint8_t)crc);
+}
+
+// Recompute the CRC of a complete frame after its payload was edited.
+static inline void resealFrame(uint8_t* frame, size_t len) {
+  const uint32_t crc = RtcmParser::crc24q(frame, len - 3);
+  frame[len - 3] = (uint8_t)(crc >> 16);
+  frame[len - 2] = (uint8_t)(crc >> 8);
+  frame[len - 1] = (uint8_t)crc;
+}
+
+static inline bool loadCapture(const char* path, Corpus& c) {
+  FILE* f = fopen(path, "rb");
+  if (f == nullptr) return false;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) c.data.insert(c.data.end(), chunk, chunk + n);
+  fclose(f);
+  const char* base = strrchr(path, '/');
+  c.name = base != nullptr ? base + 1 : path;
+  return !c.data.empty();
+}
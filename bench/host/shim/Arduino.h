@@ -0,0 +1,82 @@
+#pragma once
+// Host (Linux) stand-in for the subset of the Arduino-ESP32 core used by
+// the library: timing, String, Print/Stream and the FreeRTOS API.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include "FreeRtosShim.h"
+
+using std::min;
+using std::max;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+long random(long howbig);
+long random(long howsmall, long howbig);
+
+// ─── String ─────────────────────────────────────────────────────────────────
+
+class String {
+public:
+  String() {}
+  String(const char* s) : str(s != nullptr ? s : "") {}
+
+  size_t length() const { return str.size(); }
+  const char* c_str() const { return str.c_str(); }
+  bool operator==(const String& other) const { return str == other.str; }
+  bool operator!=(const String& other) const { return str != other.str; }
+
+private:
+  std::string str;
+};
+
+// ─── Print / Stream ─────────────────────────────────────────────────────────
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t b) = 0;
+  virtual size_t write(const uint8_t* data, size_t len) {
+    size_t n = 0;
+    while (len-- > 0) n += write(*data++);
+    return n;
+  }
+  size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+// Discards output; the benchmarks and harnesses supply their own Print sinks.
+class HardwareSerial : public Stream {
+public:
+  size_t write(uint8_t) override { return 1; }
+  size_t write(const uint8_t*, size_t len) override { return len; }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+
+// ─── IPAddress ──────────────────────────────────────────────────────────────
+// IPv4 address in network byte order, as lwIP's s_addr.
+
+class IPAddress {
+public:
+  IPAddress() {}
+  IPAddress(uint32_t addr) : addr(addr) {}
+  operator uint32_t() const { return addr; }
+
+private:
+  uint32_t addr = 0;
+};
@@ -0,0 +1,47 @@
+#pragma once
+// Host FreeRTOS subset backed by std::thread: tasks, mutexes, delays and
+// direct-to-task notifications. Core affinity and priorities are ignored.
+
+#include <stdint.h>
+
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void*);
+typedef uint8_t StackType_t;  // ESP-IDF: stack depths are in bytes
+struct StaticTask_t { void* reserved[4]; };
+
+struct HostTask;
+struct HostMutex;
+typedef HostTask* TaskHandle_t;
+typedef HostMutex* SemaphoreHandle_t;
+
+#define pdPASS 1
+#define pdFAIL 0
+#define pdTRUE 1
+#define pdFALSE 0
+#define portMAX_DELAY 0xFFFFFFFFu
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))  // 1 kHz tick
+#define configMAX_PRIORITIES 25
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t timeout);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackBytes,
+                                   void* arg, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core);
+// The stack and control block are not used; the thread gets its own.
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t fn, const char* name,
+                                           uint32_t stackBytes, void* arg,
+                                           UBaseType_t priority, StackType_t* stack,
+                                           StaticTask_t* tcb, BaseType_t core);
+// Host threads are not measured: reports the stack size the task was created with.
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+// Deleting the calling task (nullptr) is a no-op: the task function returns
+// right after it. Deleting another task is not supported and only detaches.
+void vTaskDelete(TaskHandle_t task);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+void vTaskDelay(TickType_t ticks);
+void xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t timeout);
@@ -0,0 +1,302 @@
+#include "Arduino.h"
+#include "WiFiClient.h"
+#include "Preferences.h"
+#include "esp_timer.h"
+#include "lwip/sockets.h"
+#include "lwip/netdb.h"
+
+#include <sys/ioctl.h>
+#include <errno.h>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+
+// ─── Timing ─────────────────────────────────────────────────────────────────
+
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+
+int64_t esp_timer_get_time() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now() - bootTime).count();
+}
+
+unsigned long millis() { return (unsigned long)(esp_timer_get_time() / 1000); }
+unsigned long micros() { return (unsigned long)esp_timer_get_time(); }
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// [0, howbig), like the ESP32 core's hardware-RNG random().
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  static thread_local std::mt19937 rng{std::random_device{}()};
+  return (long)(rng() % (unsigned long)howbig);
+}
+
+long random(long howsmall, long howbig) {
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+// ─── FreeRTOS ───────────────────────────────────────────────────────────────
+
+struct HostMutex {
+  std::timed_mutex m;
+};
+
+struct HostTask {
+  TaskFunction_t fn = nullptr;
+  void* arg = nullptr;
+  uint32_t stackBytes = 0;
+  std::mutex m;
+  std::condition_variable cv;
+  uint32_t notifications = 0;
+};
+
+// Tasks are never freed: a handle may still be notified after its task
+// function has returned, which FreeRTOS tolerates between exit and reap.
+static thread_local HostTask* currentTask = nullptr;
+
+static HostTask& selfTask() {
+  if (currentTask == nullptr) currentTask = new HostTask();  // Main thread
+  return *currentTask;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  return new HostMutex();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t timeout) {
+  if (timeout == portMAX_DELAY) {
+    mutex->m.lock();
+    return pdTRUE;
+  }
+  return mutex->m.try_lock_for(std::chrono::milliseconds(timeout)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+  mutex->m.unlock();
+  return pdTRUE;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char*, uint32_t stackBytes,
+                                   void* arg, UBaseType_t, TaskHandle_t* handle, BaseType_t) {
+  HostTask* task = new HostTask();
+  task->fn = fn;
+  task->arg = arg;
+  task->stackBytes = stackBytes;
+  if (handle != nullptr) *handle = task;
+  std::thread([task] {
+    currentTask = task;
+    task->fn(task->arg);
+  }).detach();
+  return pdPASS;
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t fn, const char* name,
+                                           uint32_t stackBytes, void* arg,
+                                           UBaseType_t priority, StackType_t*,
+                                           StaticTask_t*, BaseType_t core) {
+  TaskHandle_t handle = nullptr;
+  xTaskCreatePinnedToCore(fn, name, stackBytes, arg, priority, &handle, core);
+  return handle;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+  if (task == nullptr) task = currentTask;
+  return task != nullptr ? task->stackBytes : 0;
+}
+
+void vTaskDelete(TaskHandle_t) {}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  return currentTask;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  if (ticks == 0) {
+    std::this_thread::yield();
+    return;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+void xTaskNotifyGive(TaskHandle_t task) {
+  if (task == nullptr) return;
+  {
+    std::lock_guard<std::mutex> lock(task->m);
+    task->notifications++;
+  }
+  task->cv.notify_one();
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t timeout) {
+  HostTask& task = selfTask();
+  std::unique_lock<std::mutex> lock(task.m);
+  auto pending = [&task] { return task.notifications > 0; };
+  if (timeout == portMAX_DELAY) {
+    task.cv.wait(lock, pending);
+  } else {
+    task.cv.wait_for(lock, std::chrono::milliseconds(timeout), pending);
+  }
+  const uint32_t value = task.notifications;
+  if (value > 0) task.notifications = clearOnExit ? 0 : value - 1;
+  return value;
+}
+
+// ─── WiFiClient ─────────────────────────────────────────────────────────────
+
+struct WiFiClient::Socket {
+  explicit Socket(int fd) : fd(fd) {}
+  ~Socket() { ::close(fd); }
+  int fd;
+};
+
+WiFiClient::WiFiClient(int fd) {
+  if (fd >= 0) sock = std::make_shared<Socket>(fd);
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port, int32_t timeoutMs) {
+  stop();
+  const int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return 0;
+
+  timeval tv;
+  tv.tv_sec = timeoutMs / 1000;
+  tv.tv_usec = (timeoutMs % 1000) * 1000;
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = (uint32_t)ip;
+  if (::connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+    ::close(fd);
+    return 0;
+  }
+  sock = std::make_shared<Socket>(fd);
+  return 1;
+}
+
+int WiFiClient::connect(const char* host, uint16_t port, int32_t timeoutMs) {
+  addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* res = nullptr;
+  if (getaddrinfo(host, nullptr, &hints, &res) != 0 || res == nullptr) return 0;
+  const uint32_t ip = ((sockaddr_in*)res->ai_addr)->sin_addr.s_addr;
+  freeaddrinfo(res);
+  return connect(IPAddress(ip), port, timeoutMs);
+}
+
+uint8_t WiFiClient::connected() {
+  if (!sock) return 0;
+  uint8_t probe;
+  const ssize_t r = recv(sock->fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+  if (r > 0) return 1;
+  if (r == 0) return 0;  // Orderly shutdown by the peer
+  return errno == EAGAIN || errno == EWOULDBLOCK ? 1 : 0;
+}
+
+void WiFiClient::stop() {
+  sock.reset();
+}
+
+int WiFiClient::fd() const {
+  return sock ? sock->fd : -1;
+}
+
+int WiFiClient::setNoDelay(bool enabled) {
+  if (!sock) return -1;
+  int flag = enabled ? 1 : 0;
+  return setsockopt(sock->fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+}
+
+int WiFiClient::available() {
+  int n = 0;
+  if (!sock || ioctl(sock->fd, FIONREAD, &n) != 0) return 0;
+  return n;
+}
+
+int WiFiClient::read() {
+  uint8_t b;
+  return read(&b, 1) == 1 ? b : -1;
+}
+
+int WiFiClient::read(uint8_t* buf, size_t size) {
+  if (!sock) return -1;
+  const ssize_t r = recv(sock->fd, buf, size, MSG_DONTWAIT);
+  if (r >= 0) return (int)r;
+  return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+}
+
+int WiFiClient::peek() {
+  if (!sock) return -1;
+  uint8_t b;
+  return recv(sock->fd, &b, 1, MSG_PEEK | MSG_DONTWAIT) == 1 ? b : -1;
+}
+
+size_t WiFiClient::write(uint8_t b) {
+  return write(&b, 1);
+}
+
+size_t WiFiClient::write(const uint8_t* data, size_t len) {
+  if (!sock) return 0;
+  size_t sent = 0;
+  while (sent < len) {
+    const ssize_t r = send(sock->fd, data + sent, len - sent, MSG_NOSIGNAL);
+    if (r <= 0) break;
+    sent += (size_t)r;
+  }
+  return sent;
+}
+
+// ─── Preferences ────────────────────────────────────────────────────────────
+
+static std::mutex prefsMutex;
+static std::map<std::string, std::string> prefsStore;  // "namespace/key" -> bytes
+
+bool Preferences::begin(const char* name, bool ro) {
+  // NVS namespaces are 1..15 characters.
+  if (name == nullptr || name[0] == '\0' || strlen(name) > 15) return false;
+  ns = name;
+  readOnly = ro;
+  open = true;
+  return true;
+}
+
+void Preferences::end() { open = false; }
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+  if (!open || readOnly || key == nullptr) return 0;
+  std::lock_guard<std::mutex> lock(prefsMutex);
+  prefsStore[ns + "/" + key].assign(static_cast<const char*>(value), len);
+  return len;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+  if (!open || key == nullptr) return 0;
+  std::lock_guard<std::mutex> lock(prefsMutex);
+  auto it = prefsStore.find(ns + "/" + key);
+  if (it == prefsStore.end() || it->second.size() > maxLen) return 0;
+  memcpy(buf, it->second.data(), it->second.size());
+  return it->second.size();
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  if (!open || key == nullptr) return 0;
+  std::lock_guard<std::mutex> lock(prefsMutex);
+  auto it = prefsStore.find(ns + "/" + key);
+  return it == prefsStore.end() ? 0 : it->second.size();
+}
+
+bool Preferences::remove(const char* key) {
+  if (!open || readOnly || key == nullptr) return false;
+  std::lock_guard<std::mutex> lock(prefsMutex);
+  return prefsStore.erase(ns + "/" + key) > 0;
+}
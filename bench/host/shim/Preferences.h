@@ -0,0 +1,21 @@
+#pragma once
+// Host Preferences: the Arduino-ESP32 NVS wrapper's byte-blob subset, kept
+// in process memory (gone at exit, like an erased flash).
+
+#include "Arduino.h"
+
+class Preferences {
+public:
+  bool begin(const char* name, bool readOnly = false);
+  void end();
+
+  size_t putBytes(const char* key, const void* value, size_t len);
+  size_t getBytes(const char* key, void* buf, size_t maxLen);
+  size_t getBytesLength(const char* key);
+  bool remove(const char* key);
+
+private:
+  std::string ns;
+  bool open = false;
+  bool readOnly = false;
+};
@@ -0,0 +1,30 @@
+#pragma once
+// Host WiFiClient over POSIX sockets. Copies share the socket and the last
+// handle to go away closes it, as on Arduino-ESP32.
+
+#include "Arduino.h"
+#include <memory>
+
+class WiFiClient : public Stream {
+public:
+  WiFiClient() {}
+  WiFiClient(int fd);
+
+  int connect(IPAddress ip, uint16_t port, int32_t timeoutMs);
+  int connect(const char* host, uint16_t port, int32_t timeoutMs);
+  uint8_t connected();
+  void stop();
+  int fd() const;
+  int setNoDelay(bool enabled);
+
+  int available() override;
+  int read() override;
+  int read(uint8_t* buf, size_t size);
+  int peek() override;
+  size_t write(uint8_t b) override;
+  size_t write(const uint8_t* data, size_t len) override;
+
+private:
+  struct Socket;
+  std::shared_ptr<Socket> sock;
+};
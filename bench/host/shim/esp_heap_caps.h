@@ -0,0 +1,13 @@
+#pragma once
+// Host heap_caps: every capability maps to malloc/free.
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_8BIT     (1u << 2)
+#define MALLOC_CAP_DMA      (1u << 3)
+#define MALLOC_CAP_SPIRAM   (1u << 10)
+#define MALLOC_CAP_INTERNAL (1u << 11)
+
+inline void* heap_caps_malloc(size_t size, uint32_t) { return malloc(size); }
+inline void heap_caps_free(void* ptr) { free(ptr); }
@@ -0,0 +1,9 @@
+#pragma once
+// lwIP's BSD socket API maps directly onto POSIX on the host.
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
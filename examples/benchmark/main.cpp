@@ -0,0 +1,333 @@
+/**
+ * NTRIP Client — On-target Benchmark
+ *
+ * Measures the library on real hardware so regressions show up before a
+ * fleet rollout:
+ * - RtcmParser feed(byte) / bulk feed(): cycles per byte and per frame
+ * - Full taskLoop forwarding path against a loopback caster on the same
+ *   chip (127.0.0.1), for several config variants: cycles per byte,
+ *   cycles per frame, Print::write() blocking time, heap and stack
+ *   high-water marks
+ * - One run into a real UART to measure write blocking at a given baud
+ *
+ * The corpus is synthetic MSM7 traffic (GPS/GLONASS/Galileo/BeiDou + 1230,
+ * 1005/1033 every 10 s) generated into RAM at startup, with valid CRCs.
+ * No WiFi credentials needed; lwIP loopback is used (enabled in the
+ * Arduino-ESP32 sdkconfig).
+ *
+ * Compare across compile-time flags by rebuilding with, e.g.
+ *   -DNTRIP_CLIENT_CRC24Q_BACKEND=2 -DNTRIP_CLIENT_ENABLE_LATENCY_STATS=1
+ * The active flags are printed with every report.
+ */
+
+#include "NtripClient.h"
+#include "RtcmParser.h"
+#include <WiFi.h>
+#include <lwip/sockets.h>
+
+const uint32_t BENCH_EPOCHS      = 30;      // ~60 KB corpus
+const uint16_t BENCH_PORT        = 2102;
+const uint8_t  BENCH_PASSES      = 40;      // Corpus repetitions per loopback run
+const uint32_t BENCH_UART_BAUD   = 921600;  // Serial2 baud for the UART run
+const uint32_t BENCH_RUN_TIMEOUT = 30000;   // ms; runs must stay < ~17 s (32-bit CCOUNT)
+
+static uint8_t* corpus = nullptr;
+static size_t corpusLen = 0;
+static uint32_t corpusFrames = 0;
+
+// ─── Corpus generation ──────────────────────────────────────────────────────
+
+static uint32_t rngState = 1;
+
+static uint32_t rng(uint32_t lo, uint32_t hi) {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return lo + rngState % (hi - lo + 1);
+}
+
+static size_t appendFrame(uint8_t* out, uint16_t type, uint16_t len) {
+  out[0] = 0xD3;
+  out[1] = (uint8_t)(len >> 8);
+  out[2] = (uint8_t)len;
+  out[3] = (uint8_t)(type >> 4);
+  out[4] = (uint8_t)((type & 0x0F) << 4 | rng(0, 15));
+  for (uint16_t i = 2; i < len; i++) out[3 + i] = (uint8_t)rng(0, 255);
+  const uint32_t crc = RtcmParser::crc24q(out, 3 + len);
+  out[3 + len] = (uint8_t)(crc >> 16);
+  out[4 + len] = (uint8_t)(crc >> 8);
+  out[5 + len] = (uint8_t)crc;
+  return len + RtcmParser::FRAME_OVERHEAD;
+}
+
+static bool buildCorpus() {
+  struct Msg { uint16_t type; uint16_t minLen; uint16_t maxLen; };
+  static const Msg EPOCH[] = {
+    {1077, 300, 520}, {1087, 220, 400}, {1097, 260, 460}, {1127, 200, 420}, {1230, 8, 8},
+  };
+  static const Msg STATION[] = { {1005, 19, 19}, {1033, 24, 40} };
+
+  // Worst case per epoch, so the buffer is sized once.
+  const size_t cap = BENCH_EPOCHS * (5 * (520 + RtcmParser::FRAME_OVERHEAD)) +
+                     (BENCH_EPOCHS / 10 + 1) * 2 * (40 + RtcmParser::FRAME_OVERHEAD);
+  corpus = (uint8_t*)malloc(cap);
+  if (corpus == nullptr) return false;
+
+  for (uint32_t e = 0; e < BENCH_EPOCHS; e++) {
+    if (e % 10 == 0) {
+      for (const Msg& m : STATION) {
+        corpusLen += appendFrame(corpus + corpusLen, m.type, rng(m.minLen, m.maxLen));
+        corpusFrames++;
+      }
+    }
+    for (const Msg& m : EPOCH) {
+      corpusLen += appendFrame(corpus + corpusLen, m.type, rng(m.minLen, m.maxLen));
+      corpusFrames++;
+    }
+  }
+  return true;
+}
+
+// ─── Parser benchmark ───────────────────────────────────────────────────────
+
+static bool countFrame(const RtcmResult& frame, size_t, void* arg) {
+  if (frame.valid) (*static_cast<uint32_t*>(arg))++;
+  return true;
+}
+
+static void benchParser() {
+  const uint8_t reps = 10;
+  RtcmParser parser;
+  uint32_t valid = 0;
+  uint64_t cycles = 0;
+
+  for (uint8_t r = 0; r < reps; r++) {
+    const uint32_t t0 = ESP.getCycleCount();
+    for (size_t i = 0; i < corpusLen; i++) {
+      if (parser.feed(corpus[i]).valid) valid++;
+    }
+    cycles += ESP.getCycleCount() - t0;
+  }
+  Serial.printf("parser feed(byte)   %6.2f cyc/B  %7.0f cyc/frame  (%lu valid)\n",
+                (double)cycles / (corpusLen * reps), (double)cycles / (corpusFrames * reps),
+                (unsigned long)valid);
+
+  const size_t chunk = 2048;
+  parser.reset();
+  valid = 0;
+  cycles = 0;
+  for (uint8_t r = 0; r < reps; r++) {
+    const uint32_t t0 = ESP.getCycleCount();
+    for (size_t pos = 0; pos < corpusLen; pos += chunk) {
+      parser.feed(corpus + pos, min(chunk, corpusLen - pos), countFrame, &valid);
+    }
+    cycles += ESP.getCycleCount() - t0;
+  }
+  Serial.printf("parser feed(bulk)   %6.2f cyc/B  %7.0f cyc/frame  (%lu valid)\n",
+                (double)cycles / (corpusLen * reps), (double)cycles / (corpusFrames * reps),
+                (unsigned long)valid);
+}
+
+// ─── Loopback caster ────────────────────────────────────────────────────────
+// Accepts one client at a time, answers any request with ICY 200 and sends
+// the corpus BENCH_PASSES times, then idles until the client hangs up.
+
+static volatile uint8_t casterPasses = BENCH_PASSES;
+
+static void casterTask(void*) {
+  const int listener = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(BENCH_PORT);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  bind(listener, (sockaddr*)&addr, sizeof(addr));
+  listen(listener, 1);
+
+  for (;;) {
+    const int fd = accept(listener, nullptr, nullptr);
+    if (fd < 0) continue;
+
+    // Request ends with an empty line.
+    char req[512];
+    size_t got = 0;
+    while (got < sizeof(req) - 1) {
+      const int n = recv(fd, req + got, sizeof(req) - 1 - got, 0);
+      if (n <= 0) break;
+      got += n;
+      req[got] = '\0';
+      if (strstr(req, "\r\n\r\n") != nullptr) break;
+    }
+
+    static const char OK[] = "ICY 200 OK\r\n\r\n";
+    send(fd, OK, sizeof(OK) - 1, 0);
+    for (uint8_t p = 0; p < casterPasses; p++) {
+      if (send(fd, corpus, corpusLen, 0) != (int)corpusLen) break;
+    }
+
+    uint8_t drain[64];
+    while (recv(fd, drain, sizeof(drain), 0) > 0) {}  // GGA uplink or hang-up
+    close(fd);
+  }
+}
+
+// ─── Instrumented sink ──────────────────────────────────────────────────────
+// Runs in the task that writes the GNSS output (NtripClient, or NtripWriter
+// with an output ring), so its cycle counter and stack are that task's.
+
+class BenchSink : public Print {
+public:
+  explicit BenchSink(Print* out = nullptr) : out(out) {}
+
+  size_t write(uint8_t b) override { return write(&b, 1); }
+
+  size_t write(const uint8_t* data, size_t len) override {
+    const uint32_t t0 = ESP.getCycleCount();
+    if (bytes == 0) firstCycle = t0;
+    if (out != nullptr) out->write(data, len);
+    const uint32_t blocked = ESP.getCycleCount() - t0;
+    blockCycles += blocked;
+    if (blocked > maxBlockCycles) maxBlockCycles = blocked;
+    writes++;
+    bytes += len;
+    lastCycle = ESP.getCycleCount();
+    if (bytes >= expected && stackHighWater == 0) {
+      stackHighWater = uxTaskGetStackHighWaterMark(nullptr);
+    }
+    return len;
+  }
+
+  Print* out;
+  size_t expected = 0;
+  volatile size_t bytes = 0;
+  uint32_t writes = 0;
+  uint32_t firstCycle = 0;
+  uint32_t lastCycle = 0;
+  uint64_t blockCycles = 0;
+  uint32_t maxBlockCycles = 0;
+  UBaseType_t stackHighWater = 0;
+};
+
+// ─── Full-path benchmark ────────────────────────────────────────────────────
+
+static NtripClientConfig baseConfig() {
+  NtripClientConfig cfg;
+  cfg.host = "127.0.0.1";
+  cfg.port = BENCH_PORT;
+  cfg.mount = "BENCH";
+  cfg.bufferSize = 2048;
+  cfg.retryDelayMs = 1000;
+  cfg.connectTimeoutMs = 2000;
+  cfg.continuousValidation = true;  // Exact totalFrames / crcErrors
+  return cfg;
+}
+
+static void benchClient(const char* name, const NtripClientConfig& cfg, Print* out,
+                        uint8_t passes) {
+  static NtripClient ntrip;
+  BenchSink sink(out);
+  sink.expected = corpusLen * passes;
+  casterPasses = passes;
+
+  const uint32_t heapBefore = ESP.getFreeHeap();
+  if (!ntrip.begin(cfg, sink) || !ntrip.startTask(0)) {
+    Serial.printf("%-22s begin/startTask failed\n", name);
+    return;
+  }
+
+  const unsigned long start = millis();
+  while (sink.bytes < sink.expected && millis() - start < BENCH_RUN_TIMEOUT) delay(10);
+  delay(50);  // Let the final stats flush land
+
+  const NtripStats s = ntrip.getStats();
+  TaskHandle_t task = xTaskGetHandle("NtripClient");
+  const UBaseType_t clientStack = task != nullptr ? uxTaskGetStackHighWaterMark(task) : 0;
+  const uint32_t minHeap = ESP.getMinFreeHeap();
+  const uint32_t heapRunning = ESP.getFreeHeap();
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+  const NtripLatencyStats lat = ntrip.getLatencyStats();
+#endif
+  ntrip.stopTask();
+
+  if (sink.bytes < sink.expected) {
+    Serial.printf("%-22s timed out: %u / %u bytes\n", name,
+                  (unsigned)sink.bytes, (unsigned)sink.expected);
+    return;
+  }
+
+  const double cycles = (double)(sink.lastCycle - sink.firstCycle);
+  const uint32_t mhz = ESP.getCpuFreqMHz();
+  Serial.printf("%-22s %6.2f cyc/B  %7.0f cyc/frame  write avg %5.1f us max %6.1f us\n",
+                name, cycles / sink.bytes, cycles / max<uint32_t>(s.totalFrames, 1),
+                (double)sink.blockCycles / max<uint32_t>(sink.writes, 1) / mhz,
+                (double)sink.maxBlockCycles / mhz);
+  Serial.printf("%-22s frames %lu crc %lu  heap used %ld  min free %lu  "
+                "stack free: client %u sink %u\n",
+                "", (unsigned long)s.totalFrames, (unsigned long)s.crcErrors,
+                (long)heapBefore - (long)heapRunning, (unsigned long)minHeap,
+                (unsigned)clientStack, (unsigned)sink.stackHighWater);
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+  Serial.printf("%-22s latency forward avg %lu us max %lu us, write avg %lu us max %lu us\n",
+                "",
+                (unsigned long)(lat.forward.count ? lat.forward.totalUs / lat.forward.count : 0),
+                (unsigned long)lat.forward.maxUs,
+                (unsigned long)(lat.writeBlock.count ? lat.writeBlock.totalUs / lat.writeBlock.count : 0),
+                (unsigned long)lat.writeBlock.maxUs);
+#endif
+}
+
+static void printFlags() {
+  Serial.printf("CPU %lu MHz | CRC24Q_BACKEND=%d LATENCY_STATS=%d ARENA_SIZE=%d "
+                "REV1_FALLBACK=%d MAX_ENDPOINTS=%d\n",
+                (unsigned long)ESP.getCpuFreqMHz(), NTRIP_CLIENT_CRC24Q_BACKEND,
+                NTRIP_CLIENT_ENABLE_LATENCY_STATS, NTRIP_CLIENT_ARENA_SIZE,
+                NTRIP_CLIENT_ENABLE_REV1_FALLBACK, NTRIP_CLIENT_MAX_ENDPOINTS);
+  Serial.printf("corpus %u bytes, %lu frames\n\n", (unsigned)corpusLen,
+                (unsigned long)corpusFrames);
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial2.begin(BENCH_UART_BAUD);  // Adjust pins for your board
+  delay(1000);
+  Serial.println("\n=== NTRIP Client Benchmark ===\n");
+
+  WiFi.mode(WIFI_STA);  // Brings up lwIP; loopback needs no association
+  if (!buildCorpus()) {
+    Serial.println("corpus allocation failed");
+    return;
+  }
+  printFlags();
+
+  benchParser();
+  Serial.println();
+
+  xTaskCreatePinnedToCore(casterTask, "BenchCaster", 4096, nullptr, 1, nullptr, 1);
+  delay(100);
+
+  NtripClientConfig cfg = baseConfig();
+  benchClient("raw", cfg, nullptr, BENCH_PASSES);
+
+  cfg.frameAlignedOutput = true;
+  benchClient("frame-aligned", cfg, nullptr, BENCH_PASSES);
+
+  cfg.eventDrivenReads = true;
+  benchClient("+ event-driven", cfg, nullptr, BENCH_PASSES);
+
+  // Filter runs are left to bench/host: dropped frames would never let the
+  // sink reach its expected byte count.
+  cfg.outputRingSize = 8192;
+  cfg.writerCore = 0;  // Same core as the sink timer's first/last stamps
+  benchClient("+ ring", cfg, nullptr, BENCH_PASSES);
+
+  // One pass into the UART: write blocking dominates at any real baud.
+  cfg.outputRingSize = 0;
+  char name[32];
+  snprintf(name, sizeof(name), "uart %lu", (unsigned long)BENCH_UART_BAUD);
+  benchClient(name, cfg, &Serial2, 1);
+
+  Serial.println("\ndone");
+}
+
+void loop() {
+  delay(1000);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <Arduino.h>
+
+// HttpChunkDecoder: in-place decoder for HTTP/1.1 "Transfer-Encoding: chunked"
+// bodies (NTRIP Rev2).
+//
+// decode() strips chunk-size lines and CRLF delimiters from a receive buffer
+// in place and returns the number of payload bytes left at its start. State
+// carries across calls, so chunk headers may be split between reads. When a
+// read lies entirely inside one chunk no bytes are moved at all.
+
+class HttpChunkDecoder {
+public:
+  /**
+   * Prepare for a new chunked body
+   */
+  void reset();
+
+  /**
+   * Decode a span of the chunked body in place
+   * @param data Buffer holding raw body bytes; rewritten with payload only
+   * @param len Number of raw bytes
+   * @return Payload bytes now at data[0..return)
+   */
+  size_t decode(uint8_t* data, size_t len);
+
+  /**
+   * True after the terminating zero-length chunk
+   */
+  bool finished() const { return state == TRAILER; }
+
+  /**
+   * True if the framing was malformed (decoder stops producing output)
+   */
+  bool failed() const { return state == FAILED; }
+
+private:
+  enum State { SIZE, SIZE_EXT, SIZE_LF, DATA, DATA_CR, DATA_LF, TRAILER, FAILED };
+
+  void endOfSizeLine();
+
+  State state = SIZE;
+  uint32_t chunkSize = 0;
+  uint32_t remaining = 0;
+  uint8_t digits = 0;
+};
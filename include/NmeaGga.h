@@ -0,0 +1,71 @@
+#pragma once
+#include <Arduino.h>
+#include "NtripSeqlock.h"
+
+// NmeaGga: zero-allocation NMEA GGA builder for the caster uplink.
+//
+// VRS / network-RTK casters compute corrections for the rover's position,
+// so they expect a fresh GGA on the open stream every few seconds. The
+// sentence is formatted with integer fixed-point arithmetic into a caller
+// buffer: no String, no printf("%f") (newlib's dtoa may allocate).
+//
+// Tuning notes:
+// - Latitude/longitude carry 5 decimal minutes (~2 cm), enough for VRS.
+// - NtripPositionSlot hands a position from any task to the streaming task
+//   without locking: the writer never waits, the reader retries on overlap.
+
+#ifndef NTRIP_CLIENT_GGA_LEN
+#define NTRIP_CLIENT_GGA_LEN 96
+#endif
+
+struct NtripPosition {
+  double latitudeDeg = 0;     // WGS84, north positive
+  double longitudeDeg = 0;    // WGS84, east positive
+  float altitudeM = 0;        // Above mean sea level
+  float geoidSeparationM = 0;
+  float hdop = 1.0f;
+  uint32_t utcMsOfDay = 0;    // UTC time of the fix, ms since midnight
+  uint8_t fixQuality = 1;     // GGA quality: 1 GPS, 2 DGPS, 4 RTK fixed, 5 RTK float
+  uint8_t satellites = 0;
+  bool valid = false;         // false: no fix, nothing is sent
+};
+
+// Position source polled by the uplink; return false if no fix is available.
+using NtripPositionFn = bool (*)(NtripPosition& out, void* ctx);
+
+class NmeaGga {
+public:
+  /**
+   * Format a $GPGGA sentence including checksum and CRLF
+   * @param pos Position to encode
+   * @param out Destination buffer (NTRIP_CLIENT_GGA_LEN is always enough)
+   * @param cap Size of out in bytes
+   * @return Sentence length excluding the terminator, 0 if cap is too small
+   */
+  static size_t build(const NtripPosition& pos, char* out, size_t cap);
+
+  /**
+   * XOR checksum over the characters between '$' and '*'
+   */
+  static uint8_t checksum(const char* body, size_t len);
+};
+
+class NtripPositionSlot {
+public:
+  /**
+   * Writer (single task): publish the latest position
+   */
+  void publish(const NtripPosition& pos);
+
+  /**
+   * Reader: copy the latest position
+   * @param publishedMs Optional: millis() when it was published
+   * @return false if nothing has been published yet
+   */
+  bool read(NtripPosition& out, unsigned long* publishedMs = nullptr) const;
+
+private:
+  NtripPosition value;
+  unsigned long stamp = 0;
+  NtripSeqlock seq;
+};
@@ -15,18 +15,119 @@
 #define NTRIP_CLIENT_PASSIVE_SCAN_BYTES 128
 #endif
 
-// Platform gate: task mode requires FreeRTOS
+#ifndef NTRIP_CLIENT_ERROR_MSG_LEN
+#define NTRIP_CLIENT_ERROR_MSG_LEN 96
+#endif
+
+// Fixed buffers for the (heap-free) handshake: Base64 credential and each
+// pre-serialized request (line buffers: see NtripResponseParser.h).
+#ifndef NTRIP_CLIENT_AUTH_B64_LEN
+#define NTRIP_CLIENT_AUTH_B64_LEN 128
+#endif
+
+#ifndef NTRIP_CLIENT_REQUEST_LEN
+#define NTRIP_CLIENT_REQUEST_LEN 512
+#endif
+
+// >0: receive buffer, output ring, frame cache and sink queues are carved
+// from a static in-object arena of this many bytes instead of the heap at
+// task start. WiFiClient still allocates per connection (adoptHandshake()),
+// and task creation does too unless NTRIP_CLIENT_STATIC_TASKS=1.
+#ifndef NTRIP_CLIENT_ARENA_SIZE
+#define NTRIP_CLIENT_ARENA_SIZE 0
+#endif
+
+// Default stack bytes of the streaming and writer tasks. With
+// NTRIP_CLIENT_STATIC_TASKS=1 these size the in-object stacks, and the
+// configured stack sizes must fit in them.
+#ifndef NTRIP_CLIENT_TASK_STACK_SIZE
+#define NTRIP_CLIENT_TASK_STACK_SIZE 8192
+#endif
+
+#ifndef NTRIP_CLIENT_WRITER_STACK_SIZE
+#define NTRIP_CLIENT_WRITER_STACK_SIZE 4096
+#endif
+
+// 1: tasks are created with xTaskCreateStaticPinnedToCore on stacks and
+// control blocks inside the client object (no heap at task start).
+#ifndef NTRIP_CLIENT_STATIC_TASKS
+#define NTRIP_CLIENT_STATIC_TASKS 0
+#endif
+
+// Most verbose level compiled in (1 Error … 4 Debug, 0 none); calls above
+// it are removed at compile time, arguments included.
+#ifndef NTRIP_CLIENT_LOG_LEVEL
+#define NTRIP_CLIENT_LOG_LEVEL 4
+#endif
+
+// >0 (power of two): the streaming task queues log calls unformatted in a
+// lock-free ring of this many bytes; a low-priority log task formats them
+// and calls the logger. 0: the logger runs synchronously.
+#ifndef NTRIP_CLIENT_LOG_QUEUE_SIZE
+#define NTRIP_CLIENT_LOG_QUEUE_SIZE 0
+#endif
+
+#ifndef NTRIP_CLIENT_LOG_TASK_STACK
+#define NTRIP_CLIENT_LOG_TASK_STACK 3072
+#endif
+
+#ifndef NTRIP_CLIENT_LOG_TASK_PRIORITY
+#define NTRIP_CLIENT_LOG_TASK_PRIORITY 0
+#endif
+
+// Caster endpoints per client: the primary plus up to N-1 failover
+// alternates. Each costs one set of pre-serialized requests.
+#ifndef NTRIP_CLIENT_MAX_ENDPOINTS
+#define NTRIP_CLIENT_MAX_ENDPOINTS 3
+#endif
+
+// Extra correction outputs (NtripClientConfig::sinks) besides the GNSS one.
+#ifndef NTRIP_CLIENT_MAX_SINKS
+#define NTRIP_CLIENT_MAX_SINKS 2
+#endif
+
+#ifndef NTRIP_CLIENT_ENABLE_LATENCY_STATS
+#define NTRIP_CLIENT_ENABLE_LATENCY_STATS 0
+#endif
+
+#ifndef NTRIP_CLIENT_LATENCY_BUCKETS
+#define NTRIP_CLIENT_LATENCY_BUCKETS 20
+#endif
+
+// Platform gate: task mode requires FreeRTOS (or the bench/host shim, which
+// defines NTRIP_CLIENT_HOST_BUILD)
 #if NTRIP_CLIENT_ENABLE_TASK
-  #if !defined(ESP_PLATFORM) && !defined(ARDUINO_ARCH_ESP32)
+  #if !defined(ESP_PLATFORM) && !defined(ARDUINO_ARCH_ESP32) && !defined(NTRIP_CLIENT_HOST_BUILD)
     #error "NTRIP_CLIENT_ENABLE_TASK=1 requires FreeRTOS (ESP32). Set to 0 for non-RTOS targets."
   #endif
 #endif
 
 #include <WiFiClient.h>
 #include <Arduino.h>
+#include "RtcmMessageFilter.h"
+#include "SpscRingBuffer.h"
+#include "NtripResponseParser.h"
+#include "HttpChunkDecoder.h"
+#include "NmeaGga.h"
+#include "RtcmEpochTracker.h"
+#include "RtcmHealthModel.h"
+#include "NtripReconnectScheduler.h"
+#include "NtripProfile.h"
+#include "NtripLogQueue.h"
+#include "NtripSeqlock.h"
+#include <atomic>
+
+static_assert(NTRIP_CLIENT_MAX_ENDPOINTS >= 1 && NTRIP_CLIENT_MAX_ENDPOINTS <= 8,
+              "NTRIP_CLIENT_MAX_ENDPOINTS must be 1..8");
+static_assert(NTRIP_CLIENT_MAX_SINKS >= 1 && NTRIP_CLIENT_MAX_SINKS <= 8,
+              "NTRIP_CLIENT_MAX_SINKS must be 1..8");
 
 #define NTRIP_CLIENT_VERSION "2.1.0"
 
+struct RtcmResult;
+class RtcmParser;
+class RtcmFrame;
+
 // ─── Log levels ─────────────────────────────────────────────────────────────
 
 enum class NtripLogLevel : uint8_t {
@@ -38,8 +139,50 @@ enum class NtripLogLevel : uint8_t {
 
 using NtripLogFn = void (*)(NtripLogLevel level, const char* tag, const char* message);
 
+// Per-frame inspection hook; the frame is only valid during the call.
+using NtripFrameFn = void (*)(const RtcmFrame& frame, void* ctx);
+
 // ─── Configuration ──────────────────────────────────────────────────────────
 
+// Failover caster; tried in order after the primary in NtripClientConfig.
+struct NtripEndpoint {
+  String host;
+  uint16_t port = 2101;
+  String mount;
+  String user;
+  String pass;
+};
+
+enum class NtripStandbyMode : uint8_t {
+  NONE,       // Alternates are only contacted after the active caster fails
+  RESOLVED,   // Keep the next endpoint's address resolved
+  CONNECTED,  // Keep the next endpoint authenticated; its stream is discarded
+};
+
+// Where startTask() puts the receive buffer, output ring and frame cache
+// (one block of bufferSize + outputRingSize + frameCacheSize bytes).
+enum class NtripBufferPlacement : uint8_t {
+  HEAP,          // Default heap
+  INTERNAL_DMA,  // Internal RAM, DMA-capable
+  PSRAM,         // External SPI RAM
+  STATIC         // Caller-owned block (NtripClientConfig::staticBuffer)
+};
+
+// What a queued sink does with output that does not fit its queue.
+enum class NtripDropPolicy : uint8_t {
+  DROP_NEWEST,   // Drop the new chunk; the backlog is still delivered
+  DROP_BACKLOG   // Also discard the backlog, so the sink resumes with live data
+};
+
+// Extra correction output (relay rovers over UDP / TCP, a logger, ...).
+struct NtripSinkConfig {
+  Print* output = nullptr;
+  uint32_t queueSize = 0;  // 0: written inline by the streaming task (no copy);
+                           // >0: power-of-two queue drained by the sink's own task
+  NtripDropPolicy dropPolicy = NtripDropPolicy::DROP_NEWEST;
+  uint8_t core = 1;        // Core for the sink task (queueSize > 0)
+};
+
 struct NtripClientConfig {
   String host;
   uint16_t port = 2101;
@@ -47,13 +190,49 @@ struct NtripClientConfig {
   String user;
   String pass;
   String ggaSentence;                // Optional GGA sent as Ntrip-GGA header (Rev2)
+  uint32_t ggaIntervalMs = 0;       // >0: send a GGA from the position source on the stream
   uint8_t maxTries = 5;             // Reconnect attempts before lockout
-  uint32_t retryDelayMs = 30000;    // Delay between attempts
+  uint32_t retryDelayMs = 30000;    // Delay between attempts (FIXED policy)
+  NtripRetryPolicy retryPolicy = NtripRetryPolicy::FIXED;  // FIXED or jittered BACKOFF
+  bool fastFirstRetry = false;      // Retry at once after an established session is lost
+  uint32_t retryBaseDelayMs = 1000; // BACKOFF: first jitter window
+  uint32_t retryMaxDelayMs = 60000; // BACKOFF: window cap
+  uint32_t probeIntervalMs = 0;     // >0: after maxTries keep probing this often instead of LOCKED_OUT
   uint32_t healthTimeoutMs = 60000; // Zombie stream detection timeout
   uint32_t passiveSampleMs = 5000;  // Passive health check interval
   uint8_t requiredValidFrames = 3;  // Frames needed for stream validation
   uint16_t bufferSize = 1024;       // TCP read buffer size
   uint32_t connectTimeoutMs = 5000; // TCP + HTTP response timeout
+  bool continuousValidation = false; // Parse + CRC-check every frame after validation
+  bool frameAlignedOutput = false;   // Forward only whole CRC-valid frames (bufferSize >= 1029)
+  RtcmMessageFilter messageFilter;   // Per-type allow/deny + decimation (needs frameAlignedOutput)
+  uint32_t outputRingSize = 0;      // >0: SPSC ring + writer task drains to output (power of two)
+  uint8_t writerCore = 1;           // Core for the output writer task
+  uint32_t taskStackSize = NTRIP_CLIENT_TASK_STACK_SIZE;     // Streaming task stack (bytes)
+  uint8_t taskPriority = 1;                                  // Streaming task priority
+  uint32_t writerStackSize = NTRIP_CLIENT_WRITER_STACK_SIZE; // Writer task stack (bytes)
+  uint8_t writerPriority = 1;                                // Writer task priority
+  NtripBufferPlacement bufferPlacement = NtripBufferPlacement::HEAP;
+  uint8_t* staticBuffer = nullptr;  // STATIC: caller-owned, 4-byte aligned, outlives the task
+  uint32_t staticBufferSize = 0;    // Bytes at staticBuffer
+  bool eventDrivenReads = false;    // Block in select() on the socket instead of a 10 ms poll
+  uint32_t dnsCacheTtlMs = 0;       // >0: reuse the resolved caster IP for this long
+  bool rememberProtocol = false;    // Try the last working NTRIP revision first
+  bool raceProtocols = false;       // Open Rev2 + Rev1 together, keep the first 200
+  NtripEndpoint alternates[NTRIP_CLIENT_MAX_ENDPOINTS > 1 ? NTRIP_CLIENT_MAX_ENDPOINTS - 1 : 1];
+  uint8_t alternateCount = 0;       // Used entries in alternates[]
+  NtripSinkConfig sinks[NTRIP_CLIENT_MAX_SINKS];  // Outputs teed after the GNSS one
+  uint8_t sinkCount = 0;            // Used entries in sinks[]
+  NtripStandbyMode standbyMode = NtripStandbyMode::RESOLVED;  // Warm standby for failover
+  bool epochTracking = false;       // Group MSM into epochs (needs continuousValidation or frameAlignedOutput)
+  uint8_t epochStaleIntervals = 0;  // >0: zombie after this many epoch intervals without an epoch
+  bool adaptiveHealth = false;      // Zombie timeout learned per message type (needs continuous parsing)
+  uint8_t healthSigmaK = 4;         // Adaptive: stale after mean + k·σ of the tightest regular type
+  uint32_t healthMinTimeoutMs = 2000; // Adaptive: never below this (healthTimeoutMs stays the maximum)
+  uint16_t frameCacheSize = 0;      // >0: bytes caching 1005/1006/1033/1230/ephemeris for replay on reconnect
+  uint32_t frameCacheMaxAgeMs = 600000; // Replay only frames received within this window (0: any age)
+  bool persistProfile = false;      // Keep caster IP, revision, station and station frames in NVS
+  String profileNamespace = "ntrip"; // NVS namespace for the profile (1..15 chars, one per client)
 };
 
 // ─── States and errors ──────────────────────────────────────────────────────
@@ -79,21 +258,103 @@ enum class NtripError {
 };
 
 // ─── Statistics ─────────────────────────────────────────────────────────────
+// Plain-old-data so snapshots are a memcpy and never touch the heap.
+
+// Per-endpoint record for ranking casters; index 0 is the primary.
+struct NtripEndpointStats {
+  uint32_t connects = 0;       // Successful handshakes (including standby)
+  uint32_t failures = 0;       // Failed handshakes and lost sessions
+  uint32_t lastConnectMs = 0;  // TCP + HTTP handshake time of the last success
+  uint32_t avgConnectMs = 0;   // Moving average of handshake time (1/8 weight)
+  uint32_t uptimeMs = 0;       // Total time as the streaming endpoint
+  NtripError lastError = NtripError::NONE;
+};
+
+// Per-sink delivery record; index matches NtripClientConfig::sinks.
+struct NtripSinkStats {
+  uint32_t bytesWritten = 0;   // Bytes handed to the sink's write()
+  uint32_t overflows = 0;      // Chunks dropped because its queue was full
+  uint32_t droppedBytes = 0;   // Bytes in those chunks plus any discarded backlog
+  uint32_t queueHighWater = 0; // Peak bytes queued
+};
 
 struct NtripStats {
   uint32_t totalFrames = 0;
   uint32_t crcErrors = 0;
+  uint32_t framesFiltered = 0;    // Valid frames dropped by messageFilter
   uint32_t bytesReceived = 0;
   uint32_t reconnects = 0;
+  uint32_t outputRingHighWater = 0;  // Peak bytes queued in the output ring
+  uint32_t outputOverflows = 0;      // Writes dropped because the ring was full
+  uint32_t outputDroppedBytes = 0;   // Bytes in those dropped writes
   uint32_t totalUptime = 0;
   uint16_t lastMessageType = 0;
   unsigned long lastFrameTime = 0;
   unsigned long connectionStart = 0;
   NtripError lastError = NtripError::NONE;
-  String lastErrorMessage;
+  char lastErrorMessage[NTRIP_CLIENT_ERROR_MSG_LEN] = {};
   uint8_t protocolVersion = 0;  // 1 = Rev1, 2 = Rev2, 0 = not connected
+  uint32_t failovers = 0;         // Sessions moved to another endpoint
+  uint32_t standbyBytes = 0;      // Body bytes read and discarded on the standby
+  uint32_t ggaSent = 0;           // GGA sentences sent upstream
+  uint32_t ggaSkipped = 0;        // GGA intervals with no fix or the previous sentence still sending
+  uint8_t activeEndpoint = 0;     // Index into endpoints[] (0 = primary)
+  uint8_t endpointCount = 0;
+  NtripEndpointStats endpoints[NTRIP_CLIENT_MAX_ENDPOINTS];
+  RtcmEpochStats epochs;          // Epoch completeness / age / jitter (epochTracking)
+  uint32_t healthLimitMs = 0;     // Zombie timeout in force (adaptive or healthTimeoutMs)
+  uint32_t retryWaitMs = 0;       // Wait planned before the last reconnect attempt
+  uint32_t probes = 0;            // Background probes after maxTries (probeIntervalMs)
+  uint32_t framesReplayed = 0;    // Cached frames written after a connection validated
+  uint16_t frameCacheEntries = 0; // Frames held in the replay cache
+  bool profileRestored = false;   // begin() applied a stored NtripProfile
+  uint32_t taskStackFree = 0;     // Least free stack bytes seen on the streaming task
+  uint32_t writerStackFree = 0;   // Same for the writer task (outputRingSize > 0)
+  uint32_t bufferHighWater = 0;   // Peak receive-buffer fill (carry + read) in bytes
+  uint32_t workAreaBytes = 0;     // Buffer + ring + cache block in use by the task
+  uint32_t logsDropped = 0;       // Queued log calls lost to a full NTRIP_CLIENT_LOG_QUEUE_SIZE ring
+  uint8_t sinkCount = 0;
+  NtripSinkStats sinks[NTRIP_CLIENT_MAX_SINKS];
+  uint16_t profileSaves = 0;      // NVS profile writes since begin()
+};
+
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+
+// ─── Latency instrumentation ────────────────────────────────────────────────
+// Fixed log2 histograms in microseconds: bucket k counts samples in
+// [2^k, 2^(k+1)) µs (bucket 0 also holds 0 µs); the last bucket is open-ended.
+
+struct NtripLatencyHistogram {
+  uint32_t buckets[NTRIP_CLIENT_LATENCY_BUCKETS] = {};
+  uint32_t count = 0;
+  uint32_t maxUs = 0;
+  uint64_t totalUs = 0;
+
+  void record(uint32_t us) {
+    uint8_t k = us == 0 ? 0 : (uint8_t)(31 - __builtin_clz(us));
+    if (k >= NTRIP_CLIENT_LATENCY_BUCKETS) k = NTRIP_CLIENT_LATENCY_BUCKETS - 1;
+    buckets[k]++;
+    count++;
+    totalUs += us;
+    if (us > maxUs) maxUs = us;
+  }
+
+  void merge(const NtripLatencyHistogram& other) {
+    for (uint8_t k = 0; k < NTRIP_CLIENT_LATENCY_BUCKETS; k++) buckets[k] += other.buckets[k];
+    count += other.count;
+    totalUs += other.totalUs;
+    if (other.maxUs > maxUs) maxUs = other.maxUs;
+  }
+};
+
+struct NtripLatencyStats {
+  NtripLatencyHistogram forward;     // Socket read → handed to Print::write()
+  NtripLatencyHistogram loop;        // STREAMING loop iteration, excluding sleep
+  NtripLatencyHistogram writeBlock;  // Time blocked inside Print::write()
 };
 
+#endif // NTRIP_CLIENT_ENABLE_LATENCY_STATS
+
 // ─── NtripClient ────────────────────────────────────────────────────────────
 //
 // Thread-safety contract
@@ -105,7 +366,11 @@ struct NtripStats {
 // - Control methods — stop(), reset(), reconnect() — are safe from any task.
 // - Scalar runtime state (_state, _healthy) uses volatile for lock-free
 //   single-writer (taskLoop) / multiple-reader access.
-// - NtripStats is protected by statsMutex (snapshot copy on read).
+// - NtripStats is published through a seqlock: readers copy a snapshot
+//   without locking and retry if a write overlapped; writers serialize on
+//   statsMutex, so readers never block the streaming task.
+// - With outputRingSize > 0, output bytes cross to the writer task through a
+//   lock-free SPSC ring (taskLoop is the only producer).
 
 class NtripClient {
 public:
@@ -132,6 +397,11 @@ public:
   NtripStats getStats() const;
   NtripError getLastError() const;
   String getErrorMessage() const;
+  /// Heap-free variant: copies the message into out, returns its length.
+  size_t getErrorMessage(char* out, size_t len) const;
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+  NtripLatencyStats getLatencyStats() const;
+#endif
 
   // ── Control (thread-safe) ─────────────────────────────────────────────
 
@@ -142,18 +412,81 @@ public:
   // ── Configuration ─────────────────────────────────────────────────────
 
   void setLogger(NtripLogFn logger);
+  /// Position polled for the GGA uplink and the epoch time reference;
+  /// takes precedence over updatePosition(). Return the latest fix.
+  void setPositionSource(NtripPositionFn fn, void* ctx = nullptr);
+  /// Publish the latest position for the GGA uplink (single writer task).
+  void updatePosition(const NtripPosition& pos);
+  /// Called on the streaming task for every CRC-valid frame (before the
+  /// message filter), in place in the receive buffer. Needs
+  /// frameAlignedOutput; keep it short, it runs on the hot path.
+  void setFrameInspector(NtripFrameFn fn, void* ctx = nullptr);
   static bool validateConfig(const NtripClientConfig& cfg, String& errorOut);
 
+  /// Erase the persisted profile (persistProfile). Call while the task is
+  /// stopped; the next begin() starts from nothing.
+  bool clearProfile();
+
 private:
+  // Sessions reuse the endpoint slot, request builder and DNS cache.
+  friend class NtripSessionManager;
+
+  struct StreamContext;
+
   static void taskEntry(void* arg);
   void taskLoop();
-  bool connectCaster(const NtripClientConfig& cfg);
-  bool connectCasterWithVersion(const NtripClientConfig& cfg,
-                                bool useRev2,
-                                NtripError& err,
-                                String& errMsg);
+  static void writerEntry(void* arg);
+  void writerLoop();
+  static void logEntry(void* arg);
+  void logLoop();
+  void stopLogTask();
+  static void sinkEntry(void* arg);
+  void joinSinks();
+  void abortStart();
+  bool acquireWorkArea();
+  void releaseWorkArea();
+  void emit(StreamContext& ctx, const uint8_t* data, size_t len);
+  void waitReadable(uint32_t timeoutMs);
+  void sendGga(StreamContext& ctx);
+  void flushGga(StreamContext& ctx);
+  static bool onStreamFrame(const RtcmResult& frame, size_t end, void* arg);
+  void replayCache(StreamContext& ctx);
+  static void replayWrite(const uint8_t* frame, size_t len, void* arg);
+  void forwardFrameAligned(RtcmParser& parser, uint8_t* buffer, size_t n,
+                           StreamContext& ctx);
+  struct EndpointSlot;
+
+  void startSession(StreamContext& ctx, RtcmParser& parser, size_t leftover);
+  bool failover(StreamContext& ctx, RtcmParser& parser);
+  void sessionLost(StreamContext& ctx, RtcmParser& parser);
+  void nextEndpoint();
+  void serviceStandby(const NtripClientConfig& cfg);
+  void dropStandby();
+  void recordConnect(uint8_t index, uint32_t elapsedMs);
+  void recordFailure(uint8_t index, NtripError err);
+  struct Handshake;
+  void startConnect(const NtripClientConfig& cfg);
+  int stepConnect(const NtripClientConfig& cfg, uint8_t* buffer, size_t cap, size_t& leftover);
+  void abortConnect();
+  void waitHandshake(uint32_t timeoutMs);
+  void beginHandshake(Handshake& hs, uint8_t endpoint, bool rev2);
+  void stepHandshake(const NtripClientConfig& cfg, Handshake& hs, uint8_t* buf, size_t cap);
+  void finishResponse(Handshake& hs);
+  void failHandshake(Handshake& hs, NtripError err, const char* fmt, ...)
+      __attribute__((format(printf, 4, 5)));
+  void adoptHandshake(Handshake& hs, WiFiClient& into);
+  static void abortHandshake(Handshake& hs);
+  static bool resolveCaster(const NtripClientConfig& cfg, EndpointSlot& ep, IPAddress& ip);
+  bool buildRequests(const NtripClientConfig& cfg);
+  static bool buildEndpointRequests(EndpointSlot& ep, const String& user,
+                                    const String& pass, const String& gga);
+  static bool encodeBase64(const char* in, size_t len, char* out, size_t outLen);
   void disconnect();
-  void setError(NtripError err, const String& msg);
+  void setError(NtripError err, const char* fmt, ...)
+      __attribute__((format(printf, 3, 4)));
+  bool lockStats(TickType_t timeout);
+  void unlockStats();
+  void readStats(void* dst, const void* src, size_t len) const;
   void logf(NtripLogLevel level, const char* fmt, ...) const;
 
   WiFiClient client;
@@ -168,13 +501,176 @@ private:
   volatile unsigned long lastAttempt = 0;
   volatile uint8_t failures = 0;
 
-  // Aggregate stats — protected by statsMutex.
+  // Aggregate stats — written under statsMutex, published via statsSeq
+  // (odd while a write is in progress).
   NtripStats _stats;
   SemaphoreHandle_t statsMutex = nullptr;
+  NtripSeqlock statsSeq;
 
 #if NTRIP_CLIENT_ENABLE_TASK
   TaskHandle_t _taskHandle = nullptr;
+  TaskHandle_t _writerHandle = nullptr;
+#if NTRIP_CLIENT_LOG_QUEUE_SIZE > 0
+  // Deferred logging — the streaming task produces, logLoop formats.
+  TaskHandle_t _logHandle = nullptr;
+  mutable NtripLogQueue logQueue;
+  alignas(4) uint8_t logQueueStorage[NTRIP_CLIENT_LOG_QUEUE_SIZE];
+  // Profile handed to logLoop for the NVS write; owned by it while pending.
+  NtripProfile pendingProfile;
+  std::atomic<bool> profilePending{false};
+#endif
+#if NTRIP_CLIENT_STATIC_TASKS
+  StaticTask_t taskTcb;
+  StaticTask_t writerTcb;
+  StackType_t taskStack[NTRIP_CLIENT_TASK_STACK_SIZE / sizeof(StackType_t)];
+  StackType_t writerStack[NTRIP_CLIENT_WRITER_STACK_SIZE / sizeof(StackType_t)];
+  StaticTask_t sinkTcb[NTRIP_CLIENT_MAX_SINKS];
+  StackType_t sinkStack[NTRIP_CLIENT_MAX_SINKS][NTRIP_CLIENT_WRITER_STACK_SIZE / sizeof(StackType_t)];
+#if NTRIP_CLIENT_LOG_QUEUE_SIZE > 0
+  StaticTask_t logTcb;
+  StackType_t logStack[NTRIP_CLIENT_LOG_TASK_STACK / sizeof(StackType_t)];
+#endif
+#endif
 #endif
 
+  // Teed outputs. Queued sinks: emit() pushes, the sink's task drains.
+  struct SinkSlot {
+    NtripClient* self = nullptr;
+    Print* output = nullptr;
+    NtripDropPolicy dropPolicy = NtripDropPolicy::DROP_NEWEST;
+    SpscRingBuffer ring;
+    bool queued = false;
+#if NTRIP_CLIENT_ENABLE_TASK
+    TaskHandle_t handle = nullptr;
+#endif
+    std::atomic<bool> discard{false};           // Ask the sink task to drop its backlog
+    std::atomic<size_t> discardTo{0};           // ring.pushedTotal() at the overflow
+    std::atomic<uint32_t> bytesWritten{0};
+    std::atomic<uint32_t> backlogDropped{0};    // Sink task side
+    uint32_t overflows = 0;                     // Streaming task side
+    uint32_t droppedBytes = 0;
+    uint32_t highWater = 0;
+    void loop();
+  };
+  SinkSlot sinkSlots[NTRIP_CLIENT_MAX_SINKS];
+  uint8_t sinkCount = 0;
+  void emitSinks(const uint8_t* data, size_t len, bool queued);
+
+  // Receive buffer, output ring, frame cache, then the sink queues — set
+  // by startTask().
+  uint8_t* workArea = nullptr;
+  bool workAreaOwned = false;  // Allocated by acquireWorkArea() (heap_caps_free on release)
+
+  // Output ring — taskLoop produces, writerLoop consumes.
+  SpscRingBuffer outputRing;
+
+  // Response head of the current connection — task-owned.
+  NtripResponseParser response;
+
+  // Per-caster connection memory — task-owned.
+  struct CasterCache {
+    IPAddress ip;
+    unsigned long resolvedAt = 0;
+    bool ipValid = false;
+    uint8_t version = 0;  // Last revision that reached 200 (0 = unknown)
+    bool fromProfile = false;  // ip/version restored from NVS: used once, regardless of TTL
+  };
+
+  // One configured caster. host/mount point into config's Strings; the
+  // complete HTTP requests are serialized in begin() and sent with one write.
+  struct EndpointSlot {
+    const char* host = "";
+    uint16_t port = 0;
+    const char* mount = "";
+    CasterCache cache;
+    char requestRev2[NTRIP_CLIENT_REQUEST_LEN] = {};
+    uint16_t requestRev2Len = 0;
+#if NTRIP_CLIENT_ENABLE_REV1_FALLBACK
+    char requestRev1[NTRIP_CLIENT_REQUEST_LEN] = {};
+    uint16_t requestRev1Len = 0;
+#endif
+  };
+  EndpointSlot endpoints[NTRIP_CLIENT_MAX_ENDPOINTS];
+  uint8_t endpointCount = 1;
+  uint8_t activeEndpoint = 0;
+  uint8_t cycleAttempts = 0;   // Endpoints tried since the last success
+  bool skipRetryDelay = false; // Next endpoint is due immediately
+  NtripReconnectScheduler retry;
+  bool retryScheduled = false; // retry holds the plan for this DISCONNECTED spell
+
+  // One socket's non-blocking handshake — task-owned. The raw fd is handed
+  // to a WiFiClient once the response head is accepted.
+  enum class HandshakeStep : uint8_t {
+    IDLE, DNS, TCP_CONNECTING, REQUEST_SENT, HEADERS, DONE, FAILED
+  };
+  struct Handshake {
+    HandshakeStep step = HandshakeStep::IDLE;
+    uint8_t endpoint = 0;
+    bool rev2 = true;
+    int fd = -1;
+    size_t sent = 0;          // Request bytes written
+    size_t leftover = 0;      // Body bytes moved to the front of the head buffer
+    unsigned long start = 0;  // Deadline base (TCP connect onwards)
+    NtripResponseParser response;
+    NtripError err = NtripError::NONE;
+    char errMsg[NTRIP_CLIENT_ERROR_MSG_LEN] = {};
+  };
+  Handshake primaryHs;
+#if NTRIP_CLIENT_ENABLE_REV1_FALLBACK
+  Handshake rivalHs;                  // Rev1 leg of raceProtocols
+  bool connectRacing = false;
+  bool connectFallbackPending = false;  // Other revision still to try
+#endif
+  unsigned long connectStart = 0;
+
+  // Warm standby on the endpoint after the active one — task-owned.
+  enum class StandbyPhase : uint8_t { IDLE, HANDSHAKE, READY };
+  WiFiClient standby;
+  Handshake standbyHs;
+  HttpChunkDecoder standbyChunks;
+  StandbyPhase standbyPhase = StandbyPhase::IDLE;
+  uint8_t standbyEndpoint = 0;
+  bool standbyRev2 = true;
+  unsigned long standbyStart = 0;     // Handshake start or last failed attempt
+  uint32_t standbyLocalBytes = 0;
+
+#if NTRIP_CLIENT_ARENA_SIZE > 0
+  alignas(4) uint8_t arena[NTRIP_CLIENT_ARENA_SIZE];
+#endif
+
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+  // Merged histograms — published with _stats under the same seqlock.
+  NtripLatencyStats _latency;
+  // One in-flight ring sample: read timestamp of the bytes ending at markPos.
+  std::atomic<bool> latencyMarkArmed{false};
+  uint32_t latencyMarkUs = 0;
+  size_t latencyMarkPos = 0;
+#endif
+
+  // GGA uplink position source.
+  NtripPositionFn positionFn = nullptr;
+  void* positionCtx = nullptr;
+  NtripPositionSlot positionSlot;
+  bool readPosition(NtripPosition& pos, unsigned long& atMs);
+
+  // MSM epoch grouping; streaming task only, published via _stats.epochs.
+  RtcmEpochTracker epochTracker;
+  void refreshTimeReference();
+
+  // Persisted profile — loaded in begin(), rewritten by the task.
+  NtripProfile profile;
+  bool profileValid = false;
+  void restoreProfile();
+  void saveProfile(StreamContext& ctx, bool healthy);
+  bool writeProfile(const NtripProfile& next);
+
+  // Adaptive zombie timeout; streaming task only, published via _stats.healthLimitMs.
+  RtcmHealthModel healthModel;
+  uint32_t healthLimitMs() const;
+
+  // Optional deep decoding of forwarded frames (RtcmFrame).
+  NtripFrameFn frameFn = nullptr;
+  void* frameCtx = nullptr;
+
   NtripLogFn logFn = nullptr;
 };
@@ -0,0 +1,56 @@
+#pragma once
+#include <Arduino.h>
+#include <stdarg.h>
+#include <atomic>
+#include "SpscRingBuffer.h"
+
+// NtripLogQueue: deferred log formatting for the streaming task.
+//
+// push() stores the format pointer and the raw arguments it names (ints,
+// longs, doubles, pointers, and %s contents copied) as one record in an
+// SpscRingBuffer; pop() replays the format on the consumer side. The
+// producer never formats and never waits: a record that does not fit is
+// dropped and counted.
+//
+// Tuning notes:
+// - Formats must be string literals (they are read again at pop time).
+// - Supported: %d %i %u %x %X %o %c %s %p %f %e %g (and upper case) with
+//   flags, width, precision and hh/h/l/ll/z. '*' and %n are rejected.
+// - %s arguments are truncated to MAX_STRING bytes.
+
+class NtripLogQueue {
+public:
+  static constexpr size_t MAX_RECORD = 256;  // Header + arguments of one call
+  static constexpr size_t MAX_STRING = 95;   // Bytes kept per %s argument (an error message)
+
+  /**
+   * Attach caller-owned storage
+   * @param capacity Size in bytes, power of two
+   */
+  bool begin(uint8_t* storage, size_t capacity);
+
+  /**
+   * Producer: record one call
+   * @param level Caller's log level, returned by pop()
+   * @return false if the record was dropped (queue full or unsupported format)
+   */
+  bool push(uint8_t level, const char* fmt, va_list args);
+
+  /**
+   * Consumer: format the oldest record
+   * @param out Receives the NUL-terminated message (truncated to outLen)
+   * @return false if the queue is empty
+   */
+  bool pop(uint8_t& level, char* out, size_t outLen);
+
+  bool isEmpty() const { return ring.size() == 0; }
+
+  /// Records dropped by push() since begin()
+  uint32_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+private:
+  void read(uint8_t* out, size_t len);
+
+  SpscRingBuffer ring;
+  std::atomic<uint32_t> droppedCount{0};
+};
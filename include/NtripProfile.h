@@ -0,0 +1,67 @@
+#pragma once
+#include <Arduino.h>
+
+// NtripProfile: what the client learned about its caster, persisted in NVS
+// (Arduino Preferences) so a cold boot can skip the slow parts of the first
+// connect.
+//
+// Restored at begin():
+// - the endpoint that last streamed, its IPv4 address (used once, without
+//   DNS) and the NTRIP revision that reached 200
+// - the station ID and whether that session validated; a first frame from
+//   the same station then counts as a validated stream
+// - the station frames (1005/1006/1007/1008/1033/1230) for the replay cache
+//
+// Tuning notes:
+// - The profile is ignored when the caster settings (host, port, mount,
+//   user of every endpoint) changed since it was written.
+// - The client writes at most once per session, after the stream has been
+//   healthy for a while, and only when something changed. Flash wear is
+//   roughly one write per reconnect.
+// - Ephemeris is not stored; it would be stale after a reboot.
+
+#ifndef NTRIP_CLIENT_PROFILE_FRAME_BYTES
+#define NTRIP_CLIENT_PROFILE_FRAME_BYTES 256
+#endif
+
+struct NtripClientConfig;
+
+struct NtripProfile {
+  static constexpr uint32_t MAGIC = 0x4E505231;  // "NPR1"; bump on layout change
+
+  uint32_t magic = MAGIC;
+  uint32_t configHash = 0;      // NtripProfileStore::configHash() when written
+  uint32_t ip = 0;              // Caster IPv4 of that endpoint (network order)
+  uint16_t stationId = 0xFFFF;  // 0xFFFF: unknown
+  uint16_t framesLen = 0;       // Bytes used in frames[]
+  uint8_t endpoint = 0;         // Endpoint that streamed
+  uint8_t protocolVersion = 0;  // 1 = Rev1, 2 = Rev2, 0 = unknown
+  uint8_t healthy = 0;          // Last session validated (cleared by a zombie stream)
+  uint8_t reserved = 0;
+  uint8_t frames[NTRIP_CLIENT_PROFILE_FRAME_BYTES] = {};  // Whole frames, back to back
+};
+
+class NtripProfileStore {
+public:
+  /**
+   * Read a profile
+   * @param name NVS namespace (1..15 characters)
+   * @return false if absent, truncated or from another layout version
+   */
+  static bool load(const char* name, NtripProfile& out);
+
+  /**
+   * Write a profile (one NVS blob)
+   */
+  static bool save(const char* name, const NtripProfile& profile);
+
+  /**
+   * Delete the stored profile
+   */
+  static bool erase(const char* name);
+
+  /**
+   * FNV-1a over host, port, mount and user of every endpoint
+   */
+  static uint32_t configHash(const NtripClientConfig& cfg);
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include <Arduino.h>
+
+// NtripReconnectScheduler: decides when the next connection attempt is due.
+//
+// Policies:
+// - FIXED: retryDelayMs after the last attempt started (the classic
+//   behaviour).
+// - BACKOFF: full-jitter exponential backoff. The wait after the n-th
+//   consecutive failure is uniform in [0, min(retryMaxDelayMs,
+//   retryBaseDelayMs · 2^(n-1))], so a fleet that lost the caster together
+//   spreads its reconnects instead of stampeding it.
+//
+// Either policy can add an immediate first retry after an established
+// session is lost (fastFirstRetry). Callers count a session that never
+// validated as a failure, so that retry happens once per validated stream,
+// not once per HTTP 200. Once maxTries is reached, the scheduler
+// either locks out or, with probeIntervalMs > 0, keeps probing slowly
+// (uniform in [probeIntervalMs / 2, probeIntervalMs]) so a device recovers
+// on its own when the caster returns.
+//
+// Owned by the task that connects; nothing here is thread-safe.
+
+struct NtripClientConfig;
+
+enum class NtripRetryPolicy : uint8_t {
+  FIXED,    // retryDelayMs between attempt starts
+  BACKOFF,  // Full-jitter exponential backoff, retryBaseDelayMs .. retryMaxDelayMs
+};
+
+class NtripReconnectScheduler {
+public:
+  /**
+   * Take the retry settings from a (validated) config
+   */
+  void configure(const NtripClientConfig& cfg);
+
+  /**
+   * Plan the wait before the next attempt
+   * @param failures Consecutive failed attempts (0: the last session was up)
+   * @param nowMs millis()
+   * @param lastAttemptMs millis() when the last attempt started
+   * @return false if the client should lock out (maxTries reached, no probing)
+   */
+  bool schedule(uint8_t failures, unsigned long nowMs, unsigned long lastAttemptMs);
+
+  /**
+   * True once the planned wait has elapsed
+   */
+  bool due(unsigned long nowMs) const { return nowMs - from >= wait; }
+
+  /**
+   * Milliseconds until due, 0 if already due
+   */
+  unsigned long remaining(unsigned long nowMs) const {
+    return due(nowMs) ? 0 : wait - (nowMs - from);
+  }
+
+  uint32_t waitMs() const { return wait; }
+
+  /**
+   * True if the planned attempt is a background probe past maxTries
+   */
+  bool probing() const { return probe; }
+
+private:
+  static uint32_t uniform(uint32_t lo, uint32_t hi);
+
+  NtripRetryPolicy policy = NtripRetryPolicy::FIXED;
+  bool fastFirstRetry = false;
+  uint32_t fixedDelayMs = 30000;
+  uint32_t baseDelayMs = 1000;
+  uint32_t maxDelayMs = 60000;
+  uint32_t probeIntervalMs = 0;
+  uint8_t maxTries = 5;
+
+  unsigned long from = 0;
+  uint32_t wait = 0;
+  bool probe = false;
+};
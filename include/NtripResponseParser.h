@@ -0,0 +1,83 @@
+#pragma once
+#include <Arduino.h>
+
+// NtripResponseParser: incremental, allocation-free parser for the caster's
+// HTTP / ICY response head.
+//
+// Bytes are fed straight from client.read() buffers. The parser stops at
+// the end of the header block and reports how many bytes it consumed, so
+// any RTCM bytes that arrived in the same segment can be handed to the
+// streaming path instead of being discarded.
+//
+// Tuning notes:
+// - NTRIP_CLIENT_LINE_LEN bounds a single status/header line; longer lines
+//   are truncated (only the status line and two headers are inspected).
+
+#ifndef NTRIP_CLIENT_LINE_LEN
+#define NTRIP_CLIENT_LINE_LEN 128
+#endif
+
+#ifndef NTRIP_CLIENT_CONTENT_TYPE_LEN
+#define NTRIP_CLIENT_CONTENT_TYPE_LEN 48
+#endif
+
+enum class NtripResponseStatus : uint8_t {
+  PENDING,       // Status line not complete yet
+  ICY_OK,        // "ICY 200 OK" (Rev1)
+  HTTP_OK,       // "HTTP/1.x 200" (Rev2)
+  UNAUTHORIZED,  // 401
+  NOT_FOUND,     // 404, or a SOURCETABLE reply (unknown mountpoint)
+  ERROR          // Any other status
+};
+
+class NtripResponseParser {
+public:
+  /**
+   * Prepare for a new response
+   */
+  void reset();
+
+  /**
+   * Feed response bytes
+   * @param data Bytes received from the caster
+   * @param len Number of bytes
+   * @return Bytes consumed; anything after that belongs to the body
+   */
+  size_t feed(const uint8_t* data, size_t len);
+
+  /**
+   * True once the header block is complete (or the status is an error)
+   */
+  bool done() const { return state == DONE; }
+
+  NtripResponseStatus status() const { return _status; }
+  bool isOk() const {
+    return _status == NtripResponseStatus::ICY_OK || _status == NtripResponseStatus::HTTP_OK;
+  }
+  uint16_t statusCode() const { return _statusCode; }
+
+  /**
+   * True if the response carried "Transfer-Encoding: chunked"
+   */
+  bool isChunked() const { return chunked; }
+
+  const char* statusLine() const { return statusBuf; }
+  const char* contentType() const { return contentTypeBuf; }
+
+private:
+  enum State { STATUS, HEADER_START, HEADER, DONE };
+
+  void finishStatusLine();
+  void finishHeaderLine();
+  void appendLine(uint8_t b);
+
+  State state = STATUS;
+  NtripResponseStatus _status = NtripResponseStatus::PENDING;
+  uint16_t _statusCode = 0;
+  bool chunked = false;
+
+  char line[NTRIP_CLIENT_LINE_LEN] = {};
+  size_t lineLen = 0;
+  char statusBuf[NTRIP_CLIENT_LINE_LEN] = {};
+  char contentTypeBuf[NTRIP_CLIENT_CONTENT_TYPE_LEN] = {};
+};
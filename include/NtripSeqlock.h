@@ -0,0 +1,58 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+
+// NtripSeqlock: sequence counter for single-writer, many-reader snapshots.
+//
+// The writer bumps the counter to odd, modifies the protected data, then
+// bumps it back to even. Readers copy without locking and retry when the
+// counter was odd or changed during the copy, so they never block the
+// writer. Used for NtripStats (client and session manager) and the
+// published rover position.
+//
+// Tuning notes:
+// - Writers must be serialized by the caller (one task, or a mutex).
+// - The protected data must be plain bytes: a torn copy is discarded, but
+//   it is still made.
+// - A reader on the writer's core yields after a few failed attempts so a
+//   preempted writer can finish.
+
+class NtripSeqlock {
+public:
+  /// Writer: mark the protected data as being modified
+  void beginWrite() {
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  /// Writer: publish the modification
+  void endWrite() {
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  /**
+   * Reader: run copy() until it saw one consistent state
+   * @param copy Copies the protected data out; may run several times
+   * @return Number of writes completed before that state (0: never written)
+   */
+  template <typename Copy>
+  uint32_t read(Copy copy) const {
+    uint8_t spins = 0;
+    for (;;) {
+      const uint32_t before = seq.load(std::memory_order_acquire);
+      if ((before & 1) == 0) {
+        copy();
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq.load(std::memory_order_relaxed) == before) return before / 2;
+      }
+      // A preempted writer on this core needs CPU time to finish.
+      if (++spins >= 8) {
+        vTaskDelay(1);
+        spins = 0;
+      }
+    }
+  }
+
+private:
+  std::atomic<uint32_t> seq{0};  // Odd while a write is in progress
+};
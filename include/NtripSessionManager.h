@@ -0,0 +1,110 @@
+#pragma once
+
+#include "NtripClient.h"
+
+// ─── Compile-time limits ────────────────────────────────────────────────────
+
+#ifndef NTRIP_SESSION_MAX_SESSIONS
+#define NTRIP_SESSION_MAX_SESSIONS 8
+#endif
+
+#ifndef NTRIP_SESSION_TASK_STACK
+#define NTRIP_SESSION_TASK_STACK 6144
+#endif
+
+// ─── NtripSessionManager ────────────────────────────────────────────────────
+//
+// Runs several mountpoint sessions from one FreeRTOS task (or one per core
+// when sharded) instead of one NtripClient task each. Every session owns a
+// non-blocking lwIP socket, RTCM parser, receive buffer, state machine,
+// Print sink and NtripStats; the shard task multiplexes them with select().
+//
+// Session config uses the NtripClientConfig fields for the primary caster,
+// retry/health timing, bufferSize, connectTimeoutMs, dnsCacheTtlMs,
+// rememberProtocol and continuousValidation. Frame-aligned output, output
+// rings, alternates and protocol racing are NtripClient-only.
+//
+// Sinks are written inline on the shard task, so a sink that blocks stalls
+// every session on that shard. Give each session a non-blocking Print (a
+// buffered UART with enough TX space, a UDP socket, memory); a slow
+// receiver belongs on an NtripClient with outputRingSize.
+//
+// Thread-safety contract
+// ~~~~~~~~~~~~~~~~~~~~~~
+// - addSession(), start() and stop() must be called from the same context;
+//   sessions cannot be added while running.
+// - state(), isHealthy() and getStats() are safe from any task. Each
+//   session's stats have a single writer (its shard task) and are published
+//   through a per-session seqlock.
+// - reconnect() and reset() are safe from any task; the shard task applies
+//   them on its next iteration.
+
+#if NTRIP_CLIENT_ENABLE_TASK
+
+class NtripSessionManager {
+public:
+  NtripSessionManager() = default;
+  ~NtripSessionManager();
+  NtripSessionManager(const NtripSessionManager&) = delete;
+  NtripSessionManager& operator=(const NtripSessionManager&) = delete;
+
+  // ── Lifecycle ──────────────────────────────────────────────────────────
+  // Required call order: addSession()… → start() → … → stop()
+
+  /// Register a session. Returns its index, or -1 if the config is invalid,
+  /// the manager is running, or NTRIP_SESSION_MAX_SESSIONS is reached.
+  /// `sink` must not block (see above).
+  int addSession(const NtripClientConfig& cfg, Print& sink);
+  /// Start the shard task(s). With shardAcrossCores, even sessions run on
+  /// core 0 and odd sessions on core 1; otherwise all run on `core`.
+  bool start(uint8_t core = 0, bool shardAcrossCores = false);
+  /// Signal the shard task(s) to stop, wait for exit and close all sockets.
+  bool stop();
+  bool isRunning() const;
+
+  // ── Queries (thread-safe, non-blocking) ───────────────────────────────
+
+  uint8_t sessionCount() const { return count; }
+  NtripState state(uint8_t index) const;
+  bool isHealthy(uint8_t index) const;
+  NtripStats getStats(uint8_t index) const;
+
+  // ── Control (thread-safe) ─────────────────────────────────────────────
+
+  void reconnect(uint8_t index);
+  void reset(uint8_t index);
+  void setLogger(NtripLogFn logger);
+
+private:
+  struct Session;
+
+  struct Shard {
+    NtripSessionManager* self = nullptr;
+    uint8_t first = 0;   // First session index served
+    uint8_t stride = 1;  // Index step (2 when sharded across cores)
+    TaskHandle_t handle = nullptr;
+  };
+
+  static void shardEntry(void* arg);
+  void shardLoop(Shard& shard);
+  void service(Session& s, bool readable, bool writable);
+  void beginConnect(Session& s);
+  void finishConnect(Session& s);
+  void handleResponse(Session& s);
+  void handleStream(Session& s);
+  static bool onFrame(const RtcmResult& frame, size_t end, void* arg);
+  void closeSession(Session& s, NtripError err, const char* fmt, ...)
+      __attribute__((format(printf, 4, 5)));
+  void flushStats(Session& s);
+  void logf(const Session& s, NtripLogLevel level, const char* fmt, ...) const
+      __attribute__((format(printf, 4, 5)));
+
+  Session* sessions[NTRIP_SESSION_MAX_SESSIONS] = {};
+  uint8_t count = 0;
+  Shard shards[2];
+  uint8_t shardCount = 0;
+  volatile bool _running = false;
+  NtripLogFn logFn = nullptr;
+};
+
+#endif // NTRIP_CLIENT_ENABLE_TASK
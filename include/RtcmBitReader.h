@@ -0,0 +1,77 @@
+#pragma once
+#include <Arduino.h>
+
+// RtcmBitReader: zero-copy MSB-first bit-field reader over an RTCM payload.
+//
+// RTCM 3 packs fields back to back with no byte alignment. Each read loads
+// the 8 bytes covering the field as one big-endian word and extracts it with
+// a shift and mask, instead of walking bit by bit. Nothing is copied or
+// pre-decoded: the reader is a pointer and a length, and only the fields
+// actually requested are touched.
+//
+// Tuning notes:
+// - Fields up to 57 bits take one word load; 58..64 bits take two.
+// - Reads past the end return 0 (see fits()), so a truncated payload can
+//   never read outside the buffer.
+
+class RtcmBitReader {
+public:
+  RtcmBitReader(const uint8_t* data, size_t len) : data(data), len(len) {}
+
+  /**
+   * True if bits [pos, pos + count) lie inside the payload
+   */
+  bool fits(size_t pos, uint8_t count) const { return pos + count <= len * 8; }
+
+  /**
+   * Unsigned field (DF type uint)
+   * @param pos Bit offset from the start of the payload
+   * @param count Field width, 1..64
+   * @return Field value, or 0 if it does not fit
+   */
+  uint64_t getUnsigned(size_t pos, uint8_t count) const {
+    if (count == 0 || count > 64 || !fits(pos, count)) return 0;
+    if (count > 57) {
+      const uint8_t high = count - 32;
+      return getUnsigned(pos, high) << 32 | getUnsigned(pos + high, 32);
+    }
+    const uint64_t word = load(pos >> 3) << (pos & 7);
+    return word >> (64 - count);
+  }
+
+  /**
+   * Two's-complement signed field (DF type int)
+   * @return Sign-extended value, or 0 if it does not fit
+   */
+  int64_t getSigned(size_t pos, uint8_t count) const {
+    const uint64_t raw = getUnsigned(pos, count);
+    if (count == 0 || count >= 64) return (int64_t)raw;
+    const uint64_t sign = 1ULL << (count - 1);
+    return (int64_t)((raw ^ sign) - sign);
+  }
+
+  const uint8_t* bytes() const { return data; }
+  size_t size() const { return len; }
+
+private:
+  // Big-endian 64-bit word starting at byte offset, zero padded past the end.
+  uint64_t load(size_t offset) const {
+    uint64_t word = 0;
+    if (offset + 8 <= len) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+      memcpy(&word, data + offset, 8);
+      return __builtin_bswap64(word);
+#else
+      memcpy(&word, data + offset, 8);
+      return word;
+#endif
+    }
+    for (size_t i = 0; i < 8; i++) {
+      word = word << 8 | (offset + i < len ? data[offset + i] : 0);
+    }
+    return word;
+  }
+
+  const uint8_t* data;
+  size_t len;
+};
@@ -0,0 +1,163 @@
+#pragma once
+#include <Arduino.h>
+#include "RtcmFrame.h"
+
+// RtcmEpochTracker: groups MSM frames into epochs and measures stream
+// quality per constellation — completeness, correction age and jitter.
+//
+// An epoch is one physical observation time. Every MSM carries its epoch
+// time and a multiple-message bit that stays set until the last MSM of the
+// epoch (across constellations), so an epoch is complete when a frame with
+// the bit clear arrives and every constellation that was due contributed.
+// Epoch times are normalized to GPS milliseconds of day (GLONASS and
+// BeiDou run on their own time scales) so all constellations group
+// together.
+//
+// Tuning notes:
+// - All state is fixed-size; nothing is allocated. NTRIP_CLIENT_EPOCH_HISTORY
+//   epochs are kept for the jitter averages.
+// - Each constellation learns its own spacing, so a decimated constellation
+//   (e.g. BeiDou every 5 s) is only "missing" when it skips its own slot.
+// - Correction age needs a time reference (the rover's GNSS time); without
+//   one, ages read -1 and everything else still works.
+// - Single-threaded: feed it from the task that parses the stream.
+
+#ifndef NTRIP_CLIENT_EPOCH_HISTORY
+#define NTRIP_CLIENT_EPOCH_HISTORY 16
+#endif
+
+#ifndef NTRIP_CLIENT_GPS_LEAP_SECONDS
+#define NTRIP_CLIENT_GPS_LEAP_SECONDS 18
+#endif
+
+static constexpr uint8_t RTCM_GNSS_COUNT = 7;  // RtcmGnss::GPS .. NAVIC
+
+// Per-constellation summary (POD, embedded in NtripStats).
+struct RtcmGnssEpochStats {
+  uint32_t epochs = 0;       // Epochs this constellation contributed to
+  uint32_t missing = 0;      // Epoch slots it was due in but absent
+  uint32_t intervalMs = 0;   // Learned epoch spacing (0 until known)
+  int32_t ageMs = -1;        // Correction age of its last epoch; -1 without reference
+  uint32_t jitterMs = 0;     // Mean |arrival spacing − epoch spacing| over the history
+  uint32_t maxJitterMs = 0;  // Largest of those in the history
+  uint8_t frames = 0;        // MSM frames in its last epoch
+};
+
+struct RtcmEpochStats {
+  uint32_t complete = 0;     // Closed by the last MSM with every due constellation present
+  uint32_t incomplete = 0;   // Final MSM never seen, or a due constellation missing
+  uint32_t lastEpochMs = 0;  // GPS ms of day of the last closed epoch
+  int32_t ageMs = -1;        // Correction age when that epoch closed; -1 without reference
+  uint32_t intervalMs = 0;   // Learned spacing between epochs
+  uint32_t jitterMs = 0;     // Mean |close spacing − epoch spacing| over the history
+  uint32_t maxJitterMs = 0;
+  RtcmGnssEpochStats gnss[RTCM_GNSS_COUNT];  // Indexed by (uint8_t)RtcmGnss - 1
+};
+
+// One closed epoch, kept in the history ring.
+struct RtcmEpochRecord {
+  uint32_t gpsMsOfDay = 0;
+  uint32_t firstArrivalMs = 0;  // millis() of its first and last frame
+  uint32_t lastArrivalMs = 0;
+  uint8_t frames = 0;
+  uint8_t gnssMask = 0;         // Bit (RtcmGnss - 1) per contributing constellation
+  uint8_t missingMask = 0;      // Constellations that were due but absent
+  bool complete = false;
+};
+
+class RtcmEpochTracker {
+public:
+  static constexpr uint32_t DAY_MS = 86400000UL;
+  // References older than this (in local time) are ignored for ages.
+  static constexpr uint32_t REFERENCE_MAX_AGE_MS = 60000;
+
+  RtcmEpochTracker() { reset(); }
+
+  /**
+   * Forget everything, including counters
+   */
+  void reset();
+
+  /**
+   * Forget stream timing (open epoch, spacing history) but keep the
+   * counters and time reference; call when a new connection starts
+   */
+  void resetTiming();
+
+  /**
+   * Feed a CRC-valid frame; non-MSM frames are ignored
+   * @param type RTCM message type
+   * @param header Leading payload bytes (RtcmParser::header() or the frame)
+   * @param len Bytes available at header (>= 7 needed)
+   * @param nowMs Arrival time (millis())
+   * @return true if an epoch closed on this frame
+   */
+  bool onFrame(uint16_t type, const uint8_t* header, size_t len, unsigned long nowMs);
+
+  /**
+   * Set the GNSS time reference used for correction ages
+   * @param gpsMsOfDay GPS time (ms of day) that was current at localMs
+   * @param localMs millis() when that time was valid
+   */
+  void setTimeReference(uint32_t gpsMsOfDay, unsigned long localMs);
+
+  /**
+   * Milliseconds since the last epoch closed, 0 if none has yet
+   */
+  unsigned long sinceLastEpoch(unsigned long nowMs) const;
+
+  const RtcmEpochStats& stats() const { return summary; }
+
+  /**
+   * Copy the closed-epoch history, oldest first
+   * @return Records copied
+   */
+  size_t history(RtcmEpochRecord* out, size_t max) const;
+
+  /**
+   * Normalize an MSM epoch time field to GPS milliseconds of day
+   */
+  static uint32_t toGpsMsOfDay(RtcmGnss gnss, uint32_t epochTime);
+
+private:
+  struct Track {
+    uint32_t lastEpoch;
+    uint32_t lastArrival;
+    uint32_t lastDelta;    // Previous epoch spacing, to confirm a new interval
+    uint32_t nextDue;      // Next epoch time this constellation is expected at
+    uint32_t arrival;      // Last frame in the open epoch
+    uint8_t frames;        // Frames in the open epoch
+    bool seen;             // Has contributed since resetTiming()
+    uint16_t jitter[NTRIP_CLIENT_EPOCH_HISTORY];
+    uint8_t jitterCount;
+    uint8_t jitterHead;
+  };
+
+  void closeEpoch(bool sawLast);
+  int32_t ageAt(uint32_t gpsMsOfDay, uint32_t localMs) const;
+  static void learnInterval(uint32_t delta, uint32_t& lastDelta, uint32_t& interval);
+  static void pushJitter(uint16_t* ring, uint8_t& head, uint8_t& count, uint32_t value,
+                         uint32_t& mean, uint32_t& max);
+
+  Track tracks[RTCM_GNSS_COUNT];
+  RtcmEpochRecord ring[NTRIP_CLIENT_EPOCH_HISTORY];
+  uint8_t ringHead;
+  uint8_t ringCount;
+
+  RtcmEpochRecord current;
+  bool open;
+
+  uint32_t lastClose;      // Last epoch's gpsMsOfDay / close arrival
+  uint32_t lastCloseAt;
+  uint32_t lastCloseDelta;
+  bool haveClose;
+  uint16_t closeJitter[NTRIP_CLIENT_EPOCH_HISTORY];
+  uint8_t closeJitterHead;
+  uint8_t closeJitterCount;
+
+  uint32_t refGpsMs;
+  uint32_t refLocalMs;
+  bool haveRef;
+
+  RtcmEpochStats summary;
+};
@@ -0,0 +1,133 @@
+#pragma once
+#include <Arduino.h>
+#include "RtcmBitReader.h"
+
+// RtcmFrame: opt-in, on-demand decoder for one complete RTCM 3 frame.
+//
+// A frame is a view into memory the caller owns (normally the receive
+// buffer during a frame-inspector callback); nothing is copied. Each
+// accessor reads only the bit fields it needs, so asking for the station ID
+// costs one word load, and the MSM header is decoded only if requested.
+//
+// Covered messages:
+// - 1005 / 1006: station ARP (ECEF) and antenna height
+// - MSM1..MSM7 for GPS, GLONASS, Galileo, SBAS, QZSS, BeiDou, NavIC:
+//   epoch time, satellite / signal / cell counts and masks
+// - Station ID for every message type that carries it after the type field
+
+enum class RtcmGnss : uint8_t {
+  NONE, GPS, GLONASS, GALILEO, SBAS, QZSS, BEIDOU, NAVIC
+};
+
+struct RtcmStationArp {
+  uint16_t stationId = 0;
+  uint8_t itrfYear = 0;          // ITRF realization year (DF021)
+  bool gps = false;              // Service indicators
+  bool glonass = false;
+  bool galileo = false;
+  bool referenceStation = false; // false: physical station, true: non-physical
+  int64_t ecefX = 0;             // ARP ECEF, 0.1 mm units
+  int64_t ecefY = 0;
+  int64_t ecefZ = 0;
+  uint16_t antennaHeight = 0;    // 1006 only, 0.1 mm units
+};
+
+struct RtcmMsmHeader {
+  uint16_t stationId = 0;
+  uint32_t epochTime = 0;        // GNSS epoch ms (GLONASS: day-of-week << 27 | ms of day)
+  bool multipleMessage = false;  // More MSM of this epoch follow
+  uint8_t iods = 0;
+  uint64_t satelliteMask = 0;    // Bit 63 = satellite 1
+  uint32_t signalMask = 0;       // Bit 31 = signal 1
+  uint64_t cellMask = 0;         // satellites × signals bits, right aligned
+  uint8_t satellites = 0;
+  uint8_t signals = 0;
+  uint8_t cells = 0;
+};
+
+class RtcmFrame {
+public:
+  // Offsets of the MSM header fields (bits from the payload start).
+  static constexpr size_t MSM_EPOCH_POS = 24;
+  static constexpr size_t MSM_MULTIPLE_POS = 54;
+  static constexpr size_t MSM_SAT_MASK_POS = 73;
+  static constexpr size_t MSM_SIG_MASK_POS = 137;
+  static constexpr size_t MSM_CELL_MASK_POS = 169;
+
+  /**
+   * View a frame in place
+   * @param frame First byte (0xD3 preamble) of a CRC-checked frame
+   * @param len Frame length including header and CRC
+   */
+  RtcmFrame(const uint8_t* frame, size_t len);
+
+  /**
+   * Payload bits, for fields not covered by the accessors below
+   */
+  const RtcmBitReader& bits() const { return reader; }
+  const uint8_t* payload() const { return reader.bytes(); }
+  size_t payloadLength() const { return reader.size(); }
+
+  uint16_t messageType() const { return (uint16_t)reader.getUnsigned(0, 12); }
+
+  /**
+   * Reference station ID (DF003), present in 1005/1006, 1007/1008, 1033,
+   * 1230, 1001..1012 and all MSM
+   * @return false for message types without it
+   */
+  bool stationId(uint16_t& out) const;
+
+  /**
+   * True if messages of this type carry DF003 right after the type field
+   */
+  static bool hasStationId(uint16_t type);
+
+  // ── 1005 / 1006 ─────────────────────────────────────────────────────────
+
+  /**
+   * Decode the station antenna reference point
+   * @return false if the frame is not 1005/1006 or is too short
+   */
+  bool stationArp(RtcmStationArp& out) const;
+
+  // ── MSM ─────────────────────────────────────────────────────────────────
+
+  bool isMsm() const { return msmLevel() != 0; }
+
+  /**
+   * Constellation of an MSM frame (NONE for other messages)
+   */
+  RtcmGnss msmGnss() const { return msmGnssOf(messageType()); }
+
+  /**
+   * MSM level 1..7, 0 if not an MSM frame
+   */
+  uint8_t msmLevel() const { return msmLevelOf(messageType()); }
+
+  /**
+   * Same as msmGnss() / msmLevel(), from the message type alone
+   */
+  static RtcmGnss msmGnssOf(uint16_t type);
+  static uint8_t msmLevelOf(uint16_t type);
+
+  /**
+   * MSM epoch time alone (DF004 / DF034 / DF248 …)
+   * @return false if not an MSM frame
+   */
+  bool msmEpochTime(uint32_t& out) const;
+
+  /**
+   * Satellite and signal counts alone (two mask popcounts)
+   * @return false if not an MSM frame
+   */
+  bool msmCounts(uint8_t& satellites, uint8_t& signals) const;
+
+  /**
+   * Full MSM header including the cell mask
+   * @return false if not an MSM frame or the header is truncated
+   */
+  bool msmHeader(RtcmMsmHeader& out) const;
+
+private:
+  RtcmBitReader reader;
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include <Arduino.h>
+
+// RtcmFrameCache: latest copy of each slow-changing RTCM message, replayed
+// to the receiver when a new connection validates so it need not wait for
+// the caster's next 1005/1006, 1033, 1230 or ephemeris broadcast.
+//
+// Cached messages:
+// - Station-bound: 1005, 1006, 1007, 1008, 1033, 1230 — one per type,
+//   replayed only when their station ID matches the new stream's
+// - Ephemeris: 1019 (GPS), 1020 (GLONASS), 1041 (NavIC), 1042 (BeiDou),
+//   1044 (QZSS), 1045 / 1046 (Galileo) — one per type and satellite
+//
+// Storage is one caller-owned byte pool used as a log: each record is a
+// small header followed by the complete frame, newest at the end. A frame
+// that replaces its key is removed and appended again, and the oldest
+// records are evicted when the pool is full, so replay order is oldest
+// update first. Nothing is allocated.
+//
+// Tuning notes:
+// - Size the pool for what the mount sends: station messages take about
+//   250 bytes, and each satellite's ephemeris about 80 bytes (GPS + Galileo
+//   + BeiDou is roughly 6 KB).
+// - Single-threaded: store and replay from the streaming task.
+
+class RtcmFrameCache {
+public:
+  static constexpr uint16_t NO_STATION = 0xFFFF;
+
+  using WriteFn = void (*)(const uint8_t* frame, size_t len, void* ctx);
+
+  /**
+   * Attach the pool (nullptr / 0 disables the cache)
+   */
+  void begin(uint8_t* storage, size_t capacity);
+
+  void clear() { used = 0; count = 0; }
+  bool isEnabled() const { return pool != nullptr; }
+  size_t size() const { return count; }
+  size_t bytesUsed() const { return used; }
+
+  /**
+   * True for the message types this cache holds
+   */
+  static bool isCacheable(uint16_t type);
+
+  /**
+   * Store a CRC-valid frame if its type is cacheable
+   * @param frame First byte (0xD3 preamble) of the frame
+   * @param len Frame length including header and CRC
+   * @param nowMs Arrival time (millis())
+   * @return true if stored
+   */
+  bool store(const uint8_t* frame, size_t len, unsigned long nowMs);
+
+  /**
+   * Write the cached frames, oldest update first
+   * @param stationId Station of the new stream (NO_STATION: skip station-bound frames)
+   * @param maxAgeMs Skip frames stored longer ago than this (0: no limit)
+   * @return Frames written
+   */
+  size_t replay(WriteFn write, void* ctx, uint16_t stationId, uint32_t maxAgeMs,
+                unsigned long nowMs) const;
+
+  /**
+   * Copy the station-bound frames back to back (for NtripProfile)
+   * @return Bytes written; frames that do not fit are left out
+   */
+  size_t exportStation(uint8_t* out, size_t cap) const;
+
+  /**
+   * Store back-to-back frames from exportStation(), stamped nowMs
+   * @return Frames stored
+   */
+  size_t restore(const uint8_t* frames, size_t len, unsigned long nowMs);
+
+private:
+  // Record header, memcpy'd in front of each frame (pool is unaligned).
+  struct Record {
+    uint16_t type;
+    uint16_t station;   // NO_STATION for ephemeris
+    uint8_t satellite;  // 0 for station-bound
+    uint8_t reserved;
+    uint16_t length;    // Frame bytes following the header
+    uint32_t storedAt;
+  };
+
+  void removeAt(size_t offset, size_t bytes);
+
+  uint8_t* pool = nullptr;
+  size_t capacity = 0;
+  size_t used = 0;
+  size_t count = 0;
+};
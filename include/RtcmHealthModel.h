@@ -0,0 +1,98 @@
+#pragma once
+#include <Arduino.h>
+
+// RtcmHealthModel: adaptive zombie timeout learned from frame arrivals.
+//
+// Each message type keeps an EWMA of its inter-arrival interval and of the
+// squared deviation from it. A type that has been seen regularly tolerates
+// a silence of mean + k·σ; the stream limit is the tightest tolerance among
+// those types, clamped to [floor, ceiling]. A silent 1 Hz MSM stream is
+// therefore declared stale within a few seconds, while a sparse stream
+// (only 1005 every 10 s) keeps a correspondingly long timeout.
+//
+// Tuning notes:
+// - A type only counts after NTRIP_CLIENT_HEALTH_MIN_SAMPLES intervals, so
+//   one early pair of frames cannot set a tight limit.
+// - A type that misses its tolerance while other frames keep arriving is
+//   dropped and relearned; a caster that stops sending one message must not
+//   turn the rest of the stream into a zombie.
+// - Frames of one type closer than a quarter of its interval (split MSM,
+//   TCP bursts after a stall) are one arrival.
+// - Fixed table of NTRIP_CLIENT_HEALTH_TYPES slots; the least recently seen
+//   type is replaced when it fills. Single-threaded.
+
+#ifndef NTRIP_CLIENT_HEALTH_TYPES
+#define NTRIP_CLIENT_HEALTH_TYPES 16
+#endif
+
+#ifndef NTRIP_CLIENT_HEALTH_MIN_SAMPLES
+#define NTRIP_CLIENT_HEALTH_MIN_SAMPLES 4
+#endif
+
+// Learned arrival pattern of one message type.
+struct RtcmHealthTypeStats {
+  uint16_t messageType = 0;
+  uint16_t samples = 0;       // Intervals averaged since (re)learning
+  uint32_t meanMs = 0;        // EWMA inter-arrival interval
+  uint32_t sigmaMs = 0;       // EWMA standard deviation
+  uint32_t toleranceMs = 0;   // Silence tolerated: clamp(mean + k·σ)
+  bool trusted = false;       // Contributes to the stream limit
+};
+
+class RtcmHealthModel {
+public:
+  RtcmHealthModel() { reset(); }
+
+  /**
+   * Set the tolerance parameters; keeps what has been learned
+   * @param sigmaK Multiplier k in mean + k·σ
+   * @param floorMs Smallest limit ever reported
+   * @param ceilingMs Largest limit (the fixed healthTimeoutMs); longer gaps restart learning
+   */
+  void configure(uint8_t sigmaK, uint32_t floorMs, uint32_t ceilingMs);
+
+  /**
+   * Forget every type; call when a new connection starts
+   */
+  void reset();
+
+  /**
+   * Record a CRC-valid frame
+   * @param type RTCM message type
+   * @param nowMs Arrival time (millis())
+   */
+  void onFrame(uint16_t type, unsigned long nowMs);
+
+  /**
+   * Current adaptive stream limit, 0 until a type is trusted
+   */
+  uint32_t limitMs() const { return limit; }
+
+  /**
+   * Copy the per-type models, in table order
+   * @return Entries copied
+   */
+  size_t types(RtcmHealthTypeStats* out, size_t max) const;
+
+private:
+  struct Slot {
+    uint16_t type;
+    uint16_t samples;
+    uint32_t last;       // Arrival of the current burst's first frame
+    float mean;
+    float var;
+    uint32_t tolerance;
+    bool used;
+    bool trusted;
+    bool restart;        // Dropped as overdue; the next arrival starts over
+  };
+
+  Slot* slotFor(uint16_t type, uint32_t nowMs);
+  void update(Slot& s, uint32_t deltaMs);
+
+  Slot slots[NTRIP_CLIENT_HEALTH_TYPES];
+  uint32_t limit;
+  uint8_t k = 4;
+  uint32_t floorMs = 2000;
+  uint32_t ceilingMs = 60000;
+};
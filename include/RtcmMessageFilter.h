@@ -0,0 +1,109 @@
+#pragma once
+#include <Arduino.h>
+
+// RtcmMessageFilter: per-message-type allow/deny table and rate decimation
+// applied before frames are forwarded to the GNSS output.
+//
+// The allow/deny state is a 4096-bit bitset indexed by the 12-bit message
+// type, so the per-frame check is a single word test. Decimated types are
+// additionally flagged in a second bitset and resolved against a small
+// fixed slot table (NTRIP_CLIENT_MAX_DECIMATED_TYPES entries).
+//
+// Tuning notes:
+// - A default-constructed filter is inactive and accept() returns true
+//   without touching the tables.
+// - Decimation is time based: a type with interval 10000 is forwarded at
+//   most once per 10 s; interval 0 means every occurrence.
+
+#ifndef NTRIP_CLIENT_MAX_DECIMATED_TYPES
+#define NTRIP_CLIENT_MAX_DECIMATED_TYPES 8
+#endif
+
+class RtcmMessageFilter {
+public:
+  static constexpr uint16_t TYPE_COUNT = 4096;  // 12-bit message type space
+
+  RtcmMessageFilter();
+
+  /**
+   * Allow every message type (clears the deny table, keeps decimation)
+   */
+  void allowAll();
+
+  /**
+   * Deny every message type; combine with allow() to build an allowlist
+   */
+  void denyAll();
+
+  /**
+   * Allow a single message type or an inclusive range
+   */
+  void allow(uint16_t type);
+  void allow(uint16_t first, uint16_t last);
+
+  /**
+   * Deny a single message type or an inclusive range
+   */
+  void deny(uint16_t type);
+  void deny(uint16_t first, uint16_t last);
+
+  /**
+   * Forward a message type at most once per interval
+   * @param type RTCM message type
+   * @param intervalMs Minimum spacing between forwarded frames (0 removes)
+   * @return false if the slot table is full or type is out of range
+   */
+  bool setInterval(uint16_t type, uint32_t intervalMs);
+
+  /**
+   * Forget decimation timing (call on reconnect so the first frame of
+   * every decimated type is forwarded immediately)
+   */
+  void resetTiming();
+
+  /**
+   * True if any type is denied or decimated
+   */
+  bool isActive() const { return active; }
+
+  /**
+   * True unless the type is denied (decimation not applied)
+   */
+  bool allows(uint16_t type) const {
+    return !active || !(denied[(type >> 5) & (WORDS - 1)] & (1UL << (type & 31)));
+  }
+
+  /**
+   * Decide whether a frame of the given type should be forwarded
+   * @param type RTCM message type
+   * @param nowMs Current time (millis())
+   * @return true to forward, false to drop
+   */
+  bool accept(uint16_t type, unsigned long nowMs) {
+    if (!active) return true;
+    const uint32_t bit = 1UL << (type & 31);
+    const uint16_t word = (type >> 5) & (WORDS - 1);
+    if (denied[word] & bit) return false;
+    if (!(decimated[word] & bit)) return true;
+    return acceptDecimated(type, nowMs);
+  }
+
+private:
+  static constexpr uint16_t WORDS = TYPE_COUNT / 32;
+
+  struct Slot {
+    uint16_t type;
+    bool seen;
+    uint32_t intervalMs;
+    unsigned long lastForwarded;
+  };
+
+  bool acceptDecimated(uint16_t type, unsigned long nowMs);
+  void updateActive();
+
+  uint32_t denied[WORDS];
+  uint32_t decimated[WORDS];
+  Slot slots[NTRIP_CLIENT_MAX_DECIMATED_TYPES];
+  uint8_t slotCount = 0;
+  bool active = false;
+};
@@ -1,6 +1,20 @@
 #pragma once
 #include <Arduino.h>
 
+// ─── CRC24Q backend selection ───────────────────────────────────────────────
+// Override via build_flags (e.g. -DNTRIP_CLIENT_CRC24Q_BACKEND=0).
+//   0 = bitwise      — no table, 8 shift/xor steps per byte (smallest flash)
+//   1 = table        — 256-entry constexpr table, 1 KB flash
+//   2 = slice-by-4   — 4×256-entry tables, 4 KB flash, 4 bytes per step
+
+#define NTRIP_CLIENT_CRC24Q_BITWISE 0
+#define NTRIP_CLIENT_CRC24Q_TABLE   1
+#define NTRIP_CLIENT_CRC24Q_SLICE4  2
+
+#ifndef NTRIP_CLIENT_CRC24Q_BACKEND
+#define NTRIP_CLIENT_CRC24Q_BACKEND NTRIP_CLIENT_CRC24Q_TABLE
+#endif
+
 // RtcmParser: lightweight RTCM 3.x frame parser with CRC24Q validation.
 // It is optimized for streaming and only buffers enough payload bytes to
 // extract the message type (first 12 bits).
@@ -19,6 +33,15 @@ struct RtcmResult {
   uint16_t length = 0;       // Payload length in bytes
 };
 
+/**
+ * Frame callback used by the bulk feed() API
+ * @param frame Result for a completed frame (valid or CRC error)
+ * @param end Offset in the fed buffer just past the frame's last CRC byte
+ * @param ctx User context passed to feed()
+ * @return true to keep parsing, false to stop after this frame
+ */
+using RtcmFrameFn = bool (*)(const RtcmResult& frame, size_t end, void* ctx);
+
 /**
  * RTCM 3.x frame parser with CRC24Q validation
  * 
@@ -30,12 +53,34 @@ struct RtcmResult {
  */
 class RtcmParser {
 public:
+  // Preamble + 2 length bytes + 3 CRC bytes.
+  static constexpr size_t FRAME_OVERHEAD = 6;
+  // Largest possible frame (10-bit length field).
+  static constexpr size_t MAX_FRAME_SIZE = 1023 + FRAME_OVERHEAD;
+  // Leading payload bytes retained per frame (see header()).
+  static constexpr size_t HEADER_BYTES = 12;
+
   /**
    * Feed a single byte to the parser
    * @param byte Input byte from the RTCM stream
    * @return Result structure with validation status
    */
   RtcmResult feed(uint8_t byte);
+
+  /**
+   * Feed a buffer to the parser, reporting completed frames via callback
+   *
+   * Payload bytes are consumed in bulk (one CRC call per span) and SYNC
+   * bytes are skipped with memchr(), so this is considerably cheaper than
+   * calling feed(uint8_t) in a loop. Parser state carries across calls.
+   *
+   * @param data Input bytes from the RTCM stream
+   * @param len Number of bytes
+   * @param onFrame Callback invoked for every completed frame (may be null)
+   * @param ctx User context forwarded to the callback
+   * @return Bytes consumed (len, or less if the callback stopped parsing)
+   */
+  size_t feed(const uint8_t* data, size_t len, RtcmFrameFn onFrame, void* ctx);
   
   /**
    * Reset parser to initial state
@@ -47,9 +92,43 @@ public:
    */
   const char* getStateName() const;
 
+  /**
+   * Number of bytes of the in-progress frame consumed so far (0 in SYNC)
+   *
+   * Used by frame-aligned forwarding to carry a partial frame over to the
+   * next read.
+   */
+  size_t pendingBytes() const;
+
+  /**
+   * Leading payload bytes of the frame just reported
+   *
+   * Valid inside the bulk feed() callback, or after feed(uint8_t) returned
+   * a result, until the next byte is fed. Holds min(length, HEADER_BYTES)
+   * bytes — enough for an MSM epoch time and multiple-message bit.
+   */
+  const uint8_t* header() const { return payloadBuf; }
+
+  /**
+   * Compute CRC24Q over a buffer using the compile-time selected backend
+   * @param data Input bytes
+   * @param len Number of bytes
+   * @return 24-bit CRC (initial value 0)
+   */
+  static uint32_t crc24q(const uint8_t* data, size_t len);
+
+  /**
+   * Continue a running CRC24Q over a buffer
+   * @param crc Running 24-bit CRC
+   * @param data Input bytes
+   * @param len Number of bytes
+   * @return Updated 24-bit CRC
+   */
+  static uint32_t crc24q(uint32_t crc, const uint8_t* data, size_t len);
+
 private:
   // Update CRC24Q with one byte.
-  uint32_t crc24q(uint32_t crc, uint8_t byte);
+  static uint32_t crc24q(uint32_t crc, uint8_t byte);
   // Extract RTCM message type from the first two payload bytes.
   uint16_t extractMessageType();
   
@@ -60,5 +139,5 @@ private:
   uint16_t index = 0;
   uint32_t crc = 0;
   uint8_t crcBuf[3];
-  uint8_t payloadBuf[12];  // Buffer for first 12 bytes (enough for msg type)
+  uint8_t payloadBuf[HEADER_BYTES];  // First payload bytes (type, MSM epoch)
 };
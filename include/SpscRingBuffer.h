@@ -0,0 +1,70 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+
+// SpscRingBuffer: lock-free single-producer / single-consumer byte ring.
+//
+// One task pushes, one task drains; head and tail are free-running
+// counters published with release/acquire ordering, so no mutex or
+// critical section is needed even across cores.
+//
+// Tuning notes:
+// - capacity must be a power of two (index wrap is a mask).
+// - push() is all-or-nothing so frame-aligned output never emits a
+//   truncated frame when the ring is full.
+
+class SpscRingBuffer {
+public:
+  /**
+   * Attach caller-owned storage
+   * @param storage Backing memory (capacity bytes)
+   * @param capacity Size in bytes, power of two
+   * @return false if capacity is not a power of two
+   */
+  bool begin(uint8_t* storage, size_t capacity);
+
+  /**
+   * Producer: append len bytes, or nothing if they do not fit
+   * @return true if all bytes were queued
+   */
+  bool push(const uint8_t* data, size_t len);
+
+  /**
+   * Consumer: contiguous readable region starting at the tail
+   * @param data Set to the first readable byte
+   * @return Number of contiguous bytes available (0 if empty)
+   */
+  size_t peek(const uint8_t*& data) const;
+
+  /**
+   * Consumer: release len bytes previously returned by peek()
+   */
+  void consume(size_t len);
+
+  /**
+   * Bytes currently queued (approximate when called concurrently)
+   */
+  size_t size() const;
+
+  size_t capacity() const { return cap; }
+
+  /**
+   * Free-running totals of bytes pushed / consumed (wrap modulo size_t)
+   */
+  size_t pushedTotal() const { return head.load(std::memory_order_acquire); }
+  size_t consumedTotal() const { return tail.load(std::memory_order_acquire); }
+
+  /**
+   * Drop all queued bytes (only while neither side is active)
+   */
+  void clear();
+
+  static bool isPowerOfTwo(size_t n) { return n != 0 && (n & (n - 1)) == 0; }
+
+private:
+  uint8_t* buf = nullptr;
+  size_t cap = 0;
+  size_t mask = 0;
+  std::atomic<size_t> head{0};  // written by producer
+  std::atomic<size_t> tail{0};  // written by consumer
+};
@@ -0,0 +1,104 @@
+#include "HttpChunkDecoder.h"
+
+// Largest accepted chunk size; anything bigger is treated as corruption.
+static constexpr uint32_t MAX_CHUNK_SIZE = 0x00FFFFFF;
+
+static int hexValue(uint8_t b) {
+  if (b >= '0' && b <= '9') return b - '0';
+  if (b >= 'a' && b <= 'f') return b - 'a' + 10;
+  if (b >= 'A' && b <= 'F') return b - 'A' + 10;
+  return -1;
+}
+
+void HttpChunkDecoder::reset() {
+  state = SIZE;
+  chunkSize = 0;
+  remaining = 0;
+  digits = 0;
+}
+
+size_t HttpChunkDecoder::decode(uint8_t* data, size_t len) {
+  size_t out = 0;
+  size_t i = 0;
+
+  while (i < len) {
+    if (state == DATA) {
+      // Payload span: shift down only if framing was removed before it.
+      const size_t take = min(len - i, (size_t)remaining);
+      if (out != i) memmove(data + out, data + i, take);
+      out += take;
+      i += take;
+      remaining -= take;
+      if (remaining == 0) state = DATA_CR;
+      continue;
+    }
+
+    const uint8_t b = data[i++];
+    switch (state) {
+      case SIZE: {
+        // Hex chunk size, optionally followed by ";ext" or whitespace.
+        const int v = hexValue(b);
+        if (v >= 0) {
+          chunkSize = (chunkSize << 4) | (uint32_t)v;
+          if (++digits > 6 || chunkSize > MAX_CHUNK_SIZE) state = FAILED;
+        } else if (b == ';' || b == ' ' || b == '\t') {
+          state = SIZE_EXT;
+        } else if (b == '\r') {
+          state = SIZE_LF;
+        } else if (b == '\n') {
+          endOfSizeLine();
+        } else {
+          state = FAILED;
+        }
+        break;
+      }
+
+      case SIZE_EXT:
+        if (b == '\n') endOfSizeLine();
+        break;
+
+      case SIZE_LF:
+        if (b == '\n') {
+          endOfSizeLine();
+        } else {
+          state = FAILED;
+        }
+        break;
+
+      case DATA_CR:
+        // CRLF after chunk data (bare LF tolerated).
+        if (b == '\r') {
+          state = DATA_LF;
+        } else if (b == '\n') {
+          state = SIZE;
+        } else {
+          state = FAILED;
+        }
+        break;
+
+      case DATA_LF:
+        state = b == '\n' ? SIZE : FAILED;
+        break;
+
+      case TRAILER:
+      case FAILED:
+        // Nothing after the last chunk (or after corruption) is payload.
+        return out;
+
+      case DATA:
+        break;
+    }
+  }
+  return out;
+}
+
+void HttpChunkDecoder::endOfSizeLine() {
+  if (digits == 0) {
+    state = FAILED;
+    return;
+  }
+  remaining = chunkSize;
+  state = chunkSize == 0 ? TRAILER : DATA;
+  chunkSize = 0;
+  digits = 0;
+}
@@ -0,0 +1,117 @@
+#include "NmeaGga.h"
+#include <math.h>
+
+// Bounded append helpers; pos may run past cap, build() checks at the end.
+static void put(char* out, size_t cap, size_t& pos, char c) {
+  if (pos < cap) out[pos] = c;
+  pos++;
+}
+
+static void putUInt(char* out, size_t cap, size_t& pos, uint32_t v, uint8_t width) {
+  char digits[10];
+  uint8_t n = 0;
+  do {
+    digits[n++] = (char)('0' + v % 10);
+    v /= 10;
+  } while (v != 0 && n < sizeof(digits));
+  while (n < width) digits[n++] = '0';
+  while (n > 0) put(out, cap, pos, digits[--n]);
+}
+
+// Signed value with `decimals` fractional digits, rounded half away from zero.
+static void putFixed(char* out, size_t cap, size_t& pos, double v, uint8_t decimals) {
+  uint32_t scale = 1;
+  for (uint8_t i = 0; i < decimals; i++) scale *= 10;
+  if (v < 0) put(out, cap, pos, '-');
+  const uint32_t scaled = (uint32_t)llround(fabs(v) * scale);
+  putUInt(out, cap, pos, scaled / scale, 1);
+  if (decimals == 0) return;
+  put(out, cap, pos, '.');
+  putUInt(out, cap, pos, scaled % scale, decimals);
+}
+
+// ddmm.mmmmm / dddmm.mmmmm with hemisphere letter.
+static void putAngle(char* out, size_t cap, size_t& pos, double deg, uint8_t degWidth,
+                     char positive, char negative) {
+  const uint64_t minutesE5 = (uint64_t)llround(fabs(deg) * 60.0 * 100000.0);
+  putUInt(out, cap, pos, (uint32_t)(minutesE5 / 6000000), degWidth);
+  const uint32_t rem = (uint32_t)(minutesE5 % 6000000);
+  putUInt(out, cap, pos, rem / 100000, 2);
+  put(out, cap, pos, '.');
+  putUInt(out, cap, pos, rem % 100000, 5);
+  put(out, cap, pos, ',');
+  put(out, cap, pos, deg < 0 ? negative : positive);
+}
+
+size_t NmeaGga::build(const NtripPosition& pos, char* out, size_t cap) {
+  static const char HEX[] = "0123456789ABCDEF";
+  size_t n = 0;
+
+  put(out, cap, n, '$');
+  for (const char* p = "GPGGA,"; *p; p++) put(out, cap, n, *p);
+
+  // hhmmss.ss
+  const uint32_t t = pos.utcMsOfDay % 86400000UL;
+  putUInt(out, cap, n, t / 3600000, 2);
+  putUInt(out, cap, n, t / 60000 % 60, 2);
+  putUInt(out, cap, n, t / 1000 % 60, 2);
+  put(out, cap, n, '.');
+  putUInt(out, cap, n, t % 1000 / 10, 2);
+  put(out, cap, n, ',');
+
+  putAngle(out, cap, n, pos.latitudeDeg, 2, 'N', 'S');
+  put(out, cap, n, ',');
+  putAngle(out, cap, n, pos.longitudeDeg, 3, 'E', 'W');
+  put(out, cap, n, ',');
+
+  putUInt(out, cap, n, pos.fixQuality, 1);
+  put(out, cap, n, ',');
+  putUInt(out, cap, n, pos.satellites, 2);
+  put(out, cap, n, ',');
+  putFixed(out, cap, n, pos.hdop, 1);
+  put(out, cap, n, ',');
+  putFixed(out, cap, n, pos.altitudeM, 1);
+  for (const char* p = ",M,"; *p; p++) put(out, cap, n, *p);
+  putFixed(out, cap, n, pos.geoidSeparationM, 1);
+  for (const char* p = ",M,,"; *p; p++) put(out, cap, n, *p);
+
+  // Checksum covers everything between '$' and '*'.
+  const uint8_t cs = n <= cap ? checksum(out + 1, n - 1) : 0;
+  put(out, cap, n, '*');
+  put(out, cap, n, HEX[cs >> 4]);
+  put(out, cap, n, HEX[cs & 0x0F]);
+  put(out, cap, n, '\r');
+  put(out, cap, n, '\n');
+
+  if (n >= cap) {
+    if (cap > 0) out[0] = '\0';
+    return 0;
+  }
+  out[n] = '\0';
+  return n;
+}
+
+uint8_t NmeaGga::checksum(const char* body, size_t len) {
+  uint8_t cs = 0;
+  for (size_t i = 0; i < len; i++) cs ^= (uint8_t)body[i];
+  return cs;
+}
+
+void NtripPositionSlot::publish(const NtripPosition& pos) {
+  seq.beginWrite();
+  memcpy(&value, &pos, sizeof(value));
+  stamp = millis();
+  seq.endWrite();
+}
+
+bool NtripPositionSlot::read(NtripPosition& out, unsigned long* publishedMs) const {
+  unsigned long at = 0;
+  if (seq.read([&] {
+        memcpy(&out, &value, sizeof(out));
+        at = stamp;
+      }) == 0) {
+    return false;
+  }
+  if (publishedMs != nullptr) *publishedMs = at;
+  return true;
+}
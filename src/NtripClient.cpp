@@ -1,18 +1,140 @@
 #include "NtripClient.h"
 #include "RtcmParser.h"
-#include <base64.h>
+#include "RtcmFrame.h"
+#include "RtcmFrameCache.h"
 #include <stdarg.h>
+#include <lwip/sockets.h>
+#include <lwip/netdb.h>
+#if NTRIP_CLIENT_ENABLE_TASK
+#include <esp_heap_caps.h>
+#endif
+
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+#include <esp_timer.h>
+// 32-bit microsecond timestamps; differences stay valid across wrap (~71 min).
+static inline uint32_t latencyNowUs() { return (uint32_t)esp_timer_get_time(); }
+#endif
 
-#define NTRIP_LOGE(...) logf(NtripLogLevel::Error, __VA_ARGS__)
-#define NTRIP_LOGW(...) logf(NtripLogLevel::Warning, __VA_ARGS__)
-#define NTRIP_LOGI(...) logf(NtripLogLevel::Info, __VA_ARGS__)
-#define NTRIP_LOGD(...) logf(NtripLogLevel::Debug, __VA_ARGS__)
+// Calls above NTRIP_CLIENT_LOG_LEVEL sit behind a constant-false branch and
+// are compiled out, argument evaluation included.
+#define NTRIP_LOG_AT(obj, lvl, ...)                                        \
+  do {                                                                     \
+    if ((int)NtripLogLevel::lvl <= NTRIP_CLIENT_LOG_LEVEL)                 \
+      (obj).logf(NtripLogLevel::lvl, __VA_ARGS__);                         \
+  } while (0)
 
-enum class StreamPhase { VALIDATION, STREAMING };
+#define NTRIP_LOGE(...) NTRIP_LOG_AT(*this, Error, __VA_ARGS__)
+#define NTRIP_LOGW(...) NTRIP_LOG_AT(*this, Warning, __VA_ARGS__)
+#define NTRIP_LOGI(...) NTRIP_LOG_AT(*this, Info, __VA_ARGS__)
+#define NTRIP_LOGD(...) NTRIP_LOG_AT(*this, Debug, __VA_ARGS__)
+
+// VALIDATION: strict parsing until requiredValidFrames.
+// STREAMING:  passive preamble sampling every passiveSampleMs.
+// CONTINUOUS: every frame parsed and CRC-checked for the whole session.
+enum class StreamPhase { VALIDATION, STREAMING, CONTINUOUS };
 
 // Local counters are flushed to shared stats at this cadence to reduce mutex contention.
 static constexpr unsigned long STATS_FLUSH_MS = 250;
 
+// After validation, wait this long for the stream's station ID before
+// replaying cached frames without the station-bound ones.
+static constexpr unsigned long REPLAY_STATION_WAIT_MS = 2000;
+
+// A session is written to the NVS profile once it has been healthy this long.
+static constexpr unsigned long PROFILE_SAVE_DELAY_MS = 30000;
+
+// Bytes of the block startTask() carves into buffer, ring, cache and sink queues.
+static uint32_t workAreaSize(const NtripClientConfig& cfg) {
+  uint32_t bytes = (uint32_t)cfg.bufferSize + cfg.outputRingSize + cfg.frameCacheSize;
+  for (uint8_t i = 0; i < cfg.sinkCount && i < NTRIP_CLIENT_MAX_SINKS; i++) {
+    bytes += cfg.sinks[i].queueSize;
+  }
+  return bytes;
+}
+
+// Per-connection streaming state owned by taskLoop(). Local stats
+// accumulators are flushed periodically to reduce mutex contention.
+struct NtripClient::StreamContext {
+  NtripClient* self = nullptr;
+  RtcmParser* parser = nullptr;
+  StreamPhase phase = StreamPhase::VALIDATION;
+  uint8_t validFrames = 0;
+  unsigned long lastSampleTime = 0;
+  unsigned long phaseStartTime = 0;
+
+  uint32_t localBytes = 0;
+  uint32_t localFrames = 0;
+  uint32_t localCrcErrors = 0;
+  uint32_t localFiltered = 0;
+  uint32_t localRingHighWater = 0;
+  uint32_t localBufferHighWater = 0;
+  uint32_t localOverflows = 0;
+  uint32_t localDroppedBytes = 0;
+  uint16_t localLastMsgType = 0;
+  unsigned long localLastFrameTime = 0;
+
+  // Frame-aligned forwarding: bytes of a partial frame kept at the start of
+  // the receive buffer, the offset of the bytes currently being fed, and the
+  // pending contiguous run of valid frames not yet written.
+  size_t carry = 0;
+  size_t feedOffset = 0;
+  size_t spanStart = 0;
+  size_t spanEnd = 0;
+
+  // Bytes already at the front of the buffer from the handshake.
+  size_t pendingInput = 0;
+
+  // Rev2 "Transfer-Encoding: chunked" body, decoded in place.
+  bool chunked = false;
+  HttpChunkDecoder chunks;
+
+  // Last read filled the buffer — more data is likely pending, skip waiting.
+  bool readFull = false;
+
+  unsigned long lastGgaTime = 0;
+  uint32_t localGgaSent = 0;
+  uint32_t localGgaSkipped = 0;
+  // Unsent tail of the last sentence; finished before a new one starts so
+  // the caster never sees half a line.
+  char ggaTail[NTRIP_CLIENT_GGA_LEN];
+  uint8_t ggaTailLen = 0;
+
+  // Replay cache (nullptr when frameCacheSize is 0) and the new stream's
+  // station, learned from its first station-bearing frame.
+  RtcmFrameCache* cache = nullptr;
+  uint16_t stationId = RtcmFrameCache::NO_STATION;
+  uint16_t trustedStation = RtcmFrameCache::NO_STATION;  // From the profile
+  bool profileSaved = false;
+  bool replayPending = false;
+  unsigned long validatedAt = 0;
+  uint32_t localReplayed = 0;
+
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+  uint32_t readUs = 0;
+  NtripLatencyStats localLatency;
+#endif
+  uint8_t* buffer = nullptr;
+
+  void clearLocalStats() {
+    localBytes = 0;
+    localFrames = 0;
+    localCrcErrors = 0;
+    localFiltered = 0;
+    localRingHighWater = 0;
+    localBufferHighWater = 0;
+    localOverflows = 0;
+    localDroppedBytes = 0;
+    localLastMsgType = 0;
+    localLastFrameTime = 0;
+    localGgaSent = 0;
+    localGgaSkipped = 0;
+    localReplayed = 0;
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+    localLatency = NtripLatencyStats();
+#endif
+  }
+};
+
 // ─── Config validation ──────────────────────────────────────────────────────
 
 bool NtripClient::validateConfig(const NtripClientConfig& cfg, String& errorOut) {
@@ -22,7 +144,131 @@ bool NtripClient::validateConfig(const NtripClientConfig& cfg, String& errorOut)
   if (cfg.bufferSize == 0)          { errorOut = "bufferSize is zero";       return false; }
   if (cfg.connectTimeoutMs == 0)    { errorOut = "connectTimeoutMs is zero"; return false; }
   if (cfg.maxTries == 0)            { errorOut = "maxTries is zero";         return false; }
+  if (cfg.retryPolicy == NtripRetryPolicy::BACKOFF &&
+      (cfg.retryBaseDelayMs == 0 || cfg.retryMaxDelayMs < cfg.retryBaseDelayMs)) {
+    errorOut = "BACKOFF needs 0 < retryBaseDelayMs <= retryMaxDelayMs";
+    return false;
+  }
   if (cfg.healthTimeoutMs == 0)     { errorOut = "healthTimeoutMs is zero";  return false; }
+  if ((cfg.user.length() + cfg.pass.length() + 3) / 3 * 4 >= NTRIP_CLIENT_AUTH_B64_LEN) {
+    errorOut = "user/pass too long for NTRIP_CLIENT_AUTH_B64_LEN";
+    return false;
+  }
+  if (cfg.alternateCount > NTRIP_CLIENT_MAX_ENDPOINTS - 1) {
+    errorOut = "alternateCount exceeds NTRIP_CLIENT_MAX_ENDPOINTS - 1";
+    return false;
+  }
+  for (uint8_t i = 0; i < cfg.alternateCount; i++) {
+    const NtripEndpoint& alt = cfg.alternates[i];
+    if (alt.host.length() == 0 || alt.mount.length() == 0 || alt.port == 0) {
+      errorOut = "alternate endpoint needs host, mount and port";
+      return false;
+    }
+    if ((alt.user.length() + alt.pass.length() + 3) / 3 * 4 >= NTRIP_CLIENT_AUTH_B64_LEN) {
+      errorOut = "alternate user/pass too long for NTRIP_CLIENT_AUTH_B64_LEN";
+      return false;
+    }
+  }
+  if (cfg.sinkCount > NTRIP_CLIENT_MAX_SINKS) {
+    errorOut = "sinkCount exceeds NTRIP_CLIENT_MAX_SINKS";
+    return false;
+  }
+  for (uint8_t i = 0; i < cfg.sinkCount; i++) {
+    const NtripSinkConfig& sink = cfg.sinks[i];
+    if (sink.output == nullptr) {
+      errorOut = "sink needs an output";
+      return false;
+    }
+    if (sink.queueSize != 0 &&
+        (!NTRIP_CLIENT_ENABLE_TASK || !SpscRingBuffer::isPowerOfTwo(sink.queueSize))) {
+      errorOut = "sink queueSize must be 0 or a power of two (task builds only)";
+      return false;
+    }
+    // push() is all-or-nothing: a queue smaller than one read drops every full read.
+    if (sink.queueSize != 0 && sink.queueSize < cfg.bufferSize) {
+      errorOut = "sink queueSize must be >= bufferSize";
+      return false;
+    }
+  }
+  const uint32_t workAreaBytes = workAreaSize(cfg);
+#if NTRIP_CLIENT_ARENA_SIZE > 0
+  if (workAreaBytes > NTRIP_CLIENT_ARENA_SIZE) {
+    errorOut = "bufferSize + outputRingSize + frameCacheSize + sink queues exceed NTRIP_CLIENT_ARENA_SIZE";
+    return false;
+  }
+  if (cfg.bufferPlacement != NtripBufferPlacement::HEAP) {
+    errorOut = "bufferPlacement must be HEAP when NTRIP_CLIENT_ARENA_SIZE > 0";
+    return false;
+  }
+#endif
+  if (cfg.bufferPlacement == NtripBufferPlacement::STATIC &&
+      (cfg.staticBuffer == nullptr || cfg.staticBufferSize < workAreaBytes)) {
+    errorOut = "staticBuffer must hold bufferSize + outputRingSize + frameCacheSize + sink queues";
+    return false;
+  }
+#if NTRIP_CLIENT_ENABLE_TASK
+  if (cfg.taskStackSize < 2048 || cfg.writerStackSize < 2048) {
+    errorOut = "taskStackSize and writerStackSize must be >= 2048";
+    return false;
+  }
+#if NTRIP_CLIENT_STATIC_TASKS
+  if (cfg.taskStackSize > NTRIP_CLIENT_TASK_STACK_SIZE ||
+      cfg.writerStackSize > NTRIP_CLIENT_WRITER_STACK_SIZE) {
+    errorOut = "Stack sizes exceed NTRIP_CLIENT_TASK_STACK_SIZE / NTRIP_CLIENT_WRITER_STACK_SIZE";
+    return false;
+  }
+#endif
+  if (cfg.taskPriority == 0 || cfg.taskPriority >= configMAX_PRIORITIES ||
+      cfg.writerPriority == 0 || cfg.writerPriority >= configMAX_PRIORITIES) {
+    errorOut = "taskPriority and writerPriority must be 1..configMAX_PRIORITIES-1";
+    return false;
+  }
+#endif
+  if (cfg.frameAlignedOutput && cfg.bufferSize < RtcmParser::MAX_FRAME_SIZE) {
+    errorOut = "bufferSize must be >= 1029 for frameAlignedOutput";
+    return false;
+  }
+  if (cfg.outputRingSize != 0 && !SpscRingBuffer::isPowerOfTwo(cfg.outputRingSize)) {
+    errorOut = "outputRingSize must be a power of two";
+    return false;
+  }
+  if (cfg.outputRingSize != 0 && cfg.outputRingSize < cfg.bufferSize) {
+    errorOut = "outputRingSize must be >= bufferSize";
+    return false;
+  }
+  if (cfg.epochTracking && !cfg.continuousValidation && !cfg.frameAlignedOutput) {
+    errorOut = "epochTracking requires continuousValidation or frameAlignedOutput";
+    return false;
+  }
+  if (cfg.epochStaleIntervals > 0 && !cfg.epochTracking) {
+    errorOut = "epochStaleIntervals requires epochTracking";
+    return false;
+  }
+  if (cfg.adaptiveHealth && !cfg.continuousValidation && !cfg.frameAlignedOutput) {
+    errorOut = "adaptiveHealth requires continuousValidation or frameAlignedOutput";
+    return false;
+  }
+  if (cfg.frameCacheSize > 0 && !cfg.continuousValidation && !cfg.frameAlignedOutput) {
+    errorOut = "frameCacheSize requires continuousValidation or frameAlignedOutput";
+    return false;
+  }
+  if (cfg.persistProfile &&
+      (cfg.profileNamespace.length() == 0 || cfg.profileNamespace.length() > 15)) {
+    errorOut = "profileNamespace must be 1..15 characters";
+    return false;
+  }
+  if (cfg.adaptiveHealth && cfg.healthSigmaK == 0) {
+    errorOut = "healthSigmaK is zero";
+    return false;
+  }
+  if (cfg.adaptiveHealth && cfg.healthMinTimeoutMs > cfg.healthTimeoutMs) {
+    errorOut = "healthMinTimeoutMs exceeds healthTimeoutMs";
+    return false;
+  }
+  if (cfg.messageFilter.isActive() && !cfg.frameAlignedOutput) {
+    errorOut = "messageFilter requires frameAlignedOutput";
+    return false;
+  }
   return true;
 }
 
@@ -37,7 +283,35 @@ bool NtripClient::begin(const NtripClientConfig& cfg, Print& gnss) {
 
   config = cfg;
   gnssOutput = &gnss;
+  sinkCount = cfg.sinkCount;
+  for (uint8_t i = 0; i < sinkCount; i++) {
+    SinkSlot& slot = sinkSlots[i];
+    slot.self = this;
+    slot.output = cfg.sinks[i].output;
+    slot.dropPolicy = cfg.sinks[i].dropPolicy;
+    slot.queued = cfg.sinks[i].queueSize > 0;
+    slot.bytesWritten.store(0, std::memory_order_relaxed);
+    slot.backlogDropped.store(0, std::memory_order_relaxed);
+    slot.overflows = 0;
+    slot.droppedBytes = 0;
+    slot.highWater = 0;
+  }
+
+  // Serialize both requests once; reconnects reuse them without allocating.
+  if (!buildRequests(cfg)) {
+    NTRIP_LOGE("Invalid config: request exceeds NTRIP_CLIENT_REQUEST_LEN");
+    return false;
+  }
+
   failures = 0;
+  activeEndpoint = 0;
+  cycleAttempts = 0;
+  skipRetryDelay = false;
+  retry.configure(config);
+  retryScheduled = false;
+  lastAttempt = 0;
+  standbyPhase = StandbyPhase::IDLE;
+  standbyStart = 0;
   _healthy = false;
   _state = NtripState::DISCONNECTED;
   _running = false;
@@ -52,6 +326,16 @@ bool NtripClient::begin(const NtripClientConfig& cfg, Print& gnss) {
   }
 
   _stats = NtripStats();
+  _stats.endpointCount = endpointCount;
+  _stats.sinkCount = sinkCount;
+  profileValid = false;
+  if (config.persistProfile) restoreProfile();
+  epochTracker.reset();
+  healthModel.configure(config.healthSigmaK, config.healthMinTimeoutMs, config.healthTimeoutMs);
+  healthModel.reset();
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+  _latency = NtripLatencyStats();
+#endif
   NTRIP_LOGI("Initialized (v" NTRIP_CLIENT_VERSION ")");
   return true;
 }
@@ -70,18 +354,110 @@ bool NtripClient::startTask(uint8_t core) {
     return false;
   }
 
+  if (!acquireWorkArea()) {
+    NTRIP_LOGE("Buffer allocation failed (%u bytes)", (unsigned)workAreaSize(config));
+    return false;
+  }
+
   _running = true;
+
+#if NTRIP_CLIENT_LOG_QUEUE_SIZE > 0
+  // Log task first so the streaming task's first messages are queued.
+  static_assert((NTRIP_CLIENT_LOG_QUEUE_SIZE & (NTRIP_CLIENT_LOG_QUEUE_SIZE - 1)) == 0,
+                "NTRIP_CLIENT_LOG_QUEUE_SIZE must be a power of two");
+  logQueue.begin(logQueueStorage, sizeof(logQueueStorage));
+  profilePending.store(false, std::memory_order_relaxed);
+#if NTRIP_CLIENT_STATIC_TASKS
+  _logHandle = xTaskCreateStaticPinnedToCore(
+      logEntry, "NtripLog", NTRIP_CLIENT_LOG_TASK_STACK, this, NTRIP_CLIENT_LOG_TASK_PRIORITY,
+      logStack, &logTcb, core);
+#else
+  if (xTaskCreatePinnedToCore(logEntry, "NtripLog", NTRIP_CLIENT_LOG_TASK_STACK, this,
+                              NTRIP_CLIENT_LOG_TASK_PRIORITY, &_logHandle, core) != pdPASS) {
+    _logHandle = nullptr;
+  }
+#endif
+  // Without it, logging falls back to synchronous.
+  if (_logHandle == nullptr) NTRIP_LOGW("Failed to create log task — logging synchronously");
+#endif
+
+  // Optional output stage: ring buffer drained by a dedicated writer task.
+  if (config.outputRingSize > 0) {
+    if (!outputRing.begin(workArea + config.bufferSize, config.outputRingSize)) {
+      _running = false;
+      stopLogTask();
+      releaseWorkArea();
+      NTRIP_LOGE("Output ring setup failed");
+      return false;
+    }
+#if NTRIP_CLIENT_STATIC_TASKS
+    _writerHandle = xTaskCreateStaticPinnedToCore(
+        writerEntry, "NtripWriter", config.writerStackSize, this, config.writerPriority,
+        writerStack, &writerTcb, config.writerCore);
+    BaseType_t writer = _writerHandle != nullptr ? pdPASS : pdFAIL;
+#else
+    BaseType_t writer = xTaskCreatePinnedToCore(
+        writerEntry, "NtripWriter", config.writerStackSize, this, config.writerPriority,
+        &_writerHandle, config.writerCore);
+#endif
+    if (writer != pdPASS) {
+      _running = false;
+      _writerHandle = nullptr;
+      stopLogTask();
+      releaseWorkArea();
+      NTRIP_LOGE("Failed to create writer task");
+      return false;
+    }
+  }
+
+  // Queued sinks: a ring each behind the frame cache, drained by their own
+  // task so a stalled sink only stalls itself.
+  uint8_t* sinkStorage = workArea + config.bufferSize + config.outputRingSize + config.frameCacheSize;
+  for (uint8_t i = 0; i < sinkCount; i++) {
+    SinkSlot& slot = sinkSlots[i];
+    if (!slot.queued) continue;
+    slot.ring.begin(sinkStorage, config.sinks[i].queueSize);
+    sinkStorage += config.sinks[i].queueSize;
+    slot.discard.store(false, std::memory_order_relaxed);
+    slot.discardTo.store(0, std::memory_order_relaxed);
+#if NTRIP_CLIENT_STATIC_TASKS
+    slot.handle = xTaskCreateStaticPinnedToCore(
+        sinkEntry, "NtripSink", config.writerStackSize, &slot, config.writerPriority,
+        sinkStack[i], &sinkTcb[i], config.sinks[i].core);
+#else
+    if (xTaskCreatePinnedToCore(sinkEntry, "NtripSink", config.writerStackSize, &slot,
+                                config.writerPriority, &slot.handle,
+                                config.sinks[i].core) != pdPASS) {
+      slot.handle = nullptr;
+    }
+#endif
+    if (slot.handle == nullptr) {
+      abortStart();
+      NTRIP_LOGE("Failed to create sink task %u", i);
+      return false;
+    }
+  }
+
+#if NTRIP_CLIENT_STATIC_TASKS
+  _taskHandle = xTaskCreateStaticPinnedToCore(
+      taskEntry, "NtripClient", config.taskStackSize, this, config.taskPriority,
+      taskStack, &taskTcb, core);
+  BaseType_t result = _taskHandle != nullptr ? pdPASS : pdFAIL;
+#else
   BaseType_t result = xTaskCreatePinnedToCore(
-      taskEntry, "NtripClient", 8192, this, 1, &_taskHandle, core);
+      taskEntry, "NtripClient", config.taskStackSize, this, config.taskPriority,
+      &_taskHandle, core);
+#endif
 
   if (result != pdPASS) {
-    _running = false;
     _taskHandle = nullptr;
+    abortStart();
     NTRIP_LOGE("Failed to create task");
     return false;
   }
 
-  NTRIP_LOGI("Task started on core %d", core);
+  NTRIP_LOGI("Task started on core %d (%u B stack, prio %u)", core,
+             (unsigned)config.taskStackSize, config.taskPriority);
   return true;
 }
 
@@ -90,9 +466,11 @@ bool NtripClient::stopTask() {
 
   _running = false;
 
-  // Wait for task to self-terminate.
+  // Wait for tasks to self-terminate.
+  if (_writerHandle != nullptr) xTaskNotifyGive(_writerHandle);
   unsigned long start = millis();
-  while (_taskHandle != nullptr && millis() - start < 5000) {
+  while ((_taskHandle != nullptr || _writerHandle != nullptr) &&
+         millis() - start < 5000) {
     vTaskDelay(pdMS_TO_TICKS(100));
   }
 
@@ -101,6 +479,18 @@ bool NtripClient::stopTask() {
     vTaskDelete(_taskHandle);
     _taskHandle = nullptr;
   }
+  if (_writerHandle != nullptr) {
+    vTaskDelete(_writerHandle);
+    _writerHandle = nullptr;
+  }
+  joinSinks();
+  stopLogTask();
+#if NTRIP_CLIENT_STATIC_TASKS
+  // Let the idle task reap the static control blocks before a restart reuses them.
+  vTaskDelay(pdMS_TO_TICKS(20));
+#endif
+
+  releaseWorkArea();
 
   NTRIP_LOGI("Task stopped");
   return true;
@@ -110,38 +500,220 @@ bool NtripClient::isTaskRunning() const {
   return _taskHandle != nullptr && _running;
 }
 
+bool NtripClient::acquireWorkArea() {
+  const size_t bytes = workAreaSize(config);
+  workAreaOwned = false;
+#if NTRIP_CLIENT_ARENA_SIZE > 0
+  workArea = arena;
+#else
+  uint32_t caps = MALLOC_CAP_8BIT;
+  switch (config.bufferPlacement) {
+    case NtripBufferPlacement::STATIC:       workArea = config.staticBuffer; break;
+    case NtripBufferPlacement::INTERNAL_DMA: caps |= MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL; break;
+    case NtripBufferPlacement::PSRAM:        caps |= MALLOC_CAP_SPIRAM; break;
+    case NtripBufferPlacement::HEAP:         break;
+  }
+  if (config.bufferPlacement != NtripBufferPlacement::STATIC) {
+    workArea = static_cast<uint8_t*>(heap_caps_malloc(bytes, caps));
+    workAreaOwned = workArea != nullptr;
+  }
+#endif
+  if (workArea == nullptr) return false;
+  if (lockStats(portMAX_DELAY)) {
+    _stats.workAreaBytes = (uint32_t)bytes;
+    unlockStats();
+  }
+  return true;
+}
+
+void NtripClient::releaseWorkArea() {
+  if (workAreaOwned) heap_caps_free(workArea);
+  workArea = nullptr;
+  workAreaOwned = false;
+}
+
+void NtripClient::writerEntry(void* arg) {
+  static_cast<NtripClient*>(arg)->writerLoop();
+}
+
+void NtripClient::writerLoop() {
+  // Drain the output ring to the sink. Blocking in write() here only stalls
+  // this task; taskLoop keeps reading the socket.
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+  NtripLatencyStats localLatency;
+  unsigned long lastFlush = millis();
+#endif
+
+  while (_running) {
+    const uint8_t* data = nullptr;
+    size_t n = outputRing.peek(data);
+    if (n == 0) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+      continue;
+    }
+
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+    const uint32_t t0 = latencyNowUs();
+    if (latencyMarkArmed.load(std::memory_order_acquire) &&
+        outputRing.consumedTotal() + n - latencyMarkPos <= outputRing.capacity()) {
+      localLatency.forward.record(t0 - latencyMarkUs);
+      latencyMarkArmed.store(false, std::memory_order_release);
+    }
+    gnssOutput->write(data, n);
+    localLatency.writeBlock.record(latencyNowUs() - t0);
+
+    if (millis() - lastFlush >= STATS_FLUSH_MS &&
+        lockStats(pdMS_TO_TICKS(10))) {
+      _latency.forward.merge(localLatency.forward);
+      _latency.writeBlock.merge(localLatency.writeBlock);
+      unlockStats();
+      localLatency = NtripLatencyStats();
+      lastFlush = millis();
+    }
+#else
+    gnssOutput->write(data, n);
+#endif
+    outputRing.consume(n);
+  }
+
+  _writerHandle = nullptr;
+  vTaskDelete(nullptr);
+}
+
+void NtripClient::abortStart() {
+  // startTask() failed after some helper tasks were created.
+  _running = false;
+  if (_writerHandle != nullptr) {
+    xTaskNotifyGive(_writerHandle);
+    while (_writerHandle != nullptr) vTaskDelay(pdMS_TO_TICKS(10));
+  }
+  joinSinks();
+  stopLogTask();
+  releaseWorkArea();
+}
+
+void NtripClient::sinkEntry(void* arg) {
+  static_cast<SinkSlot*>(arg)->loop();
+}
+
+void NtripClient::SinkSlot::loop() {
+  // Same shape as writerLoop(); a blocking write() here stalls only this sink.
+  while (self->_running) {
+    if (discard.exchange(false, std::memory_order_acq_rel)) {
+      // Only what was queued at the overflow; chunks pushed since are live.
+      const size_t backlog = discardTo.load(std::memory_order_relaxed) - ring.consumedTotal();
+      if (backlog <= ring.size()) {
+        ring.consume(backlog);
+        backlogDropped.fetch_add((uint32_t)backlog, std::memory_order_relaxed);
+      }
+    }
+    const uint8_t* data = nullptr;
+    const size_t n = ring.peek(data);
+    if (n == 0) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+      continue;
+    }
+    output->write(data, n);
+    ring.consume(n);
+    bytesWritten.fetch_add((uint32_t)n, std::memory_order_relaxed);
+  }
+  handle = nullptr;
+  vTaskDelete(nullptr);
+}
+
+void NtripClient::joinSinks() {
+  // Called with _running false; each sink task exits after its current write.
+  const unsigned long start = millis();
+  for (uint8_t i = 0; i < sinkCount; i++) {
+    SinkSlot& slot = sinkSlots[i];
+    if (slot.handle == nullptr) continue;
+    xTaskNotifyGive(slot.handle);
+    while (slot.handle != nullptr && millis() - start < 2000) vTaskDelay(pdMS_TO_TICKS(10));
+    if (slot.handle != nullptr) {
+      vTaskDelete(slot.handle);
+      slot.handle = nullptr;
+    }
+  }
+}
+
+void NtripClient::stopLogTask() {
+#if NTRIP_CLIENT_LOG_QUEUE_SIZE > 0
+  // Called with _running false and the streaming task gone: the log task
+  // drains what is left, then exits.
+  if (_logHandle == nullptr) return;
+  xTaskNotifyGive(_logHandle);
+  const unsigned long start = millis();
+  while (_logHandle != nullptr && millis() - start < 1000) vTaskDelay(pdMS_TO_TICKS(10));
+  if (_logHandle != nullptr) {
+    vTaskDelete(_logHandle);
+    _logHandle = nullptr;
+  }
+#endif
+}
+
+#if NTRIP_CLIENT_LOG_QUEUE_SIZE > 0
+void NtripClient::logEntry(void* arg) {
+  static_cast<NtripClient*>(arg)->logLoop();
+}
+
+void NtripClient::logLoop() {
+  // Formatting, the (possibly slow) logger and profile writes run here, at
+  // low priority.
+  char message[256];
+  uint8_t level;
+  for (;;) {
+    // Sampled first: whatever the streaming task queued before it exited
+    // is handled below.
+    const bool done = !_running && _taskHandle == nullptr;
+    while (logQueue.pop(level, message, sizeof(message))) {
+      if (logFn != nullptr) logFn((NtripLogLevel)level, "NtripClient", message);
+    }
+    if (profilePending.load(std::memory_order_acquire)) {
+      writeProfile(pendingProfile);
+      profilePending.store(false, std::memory_order_release);
+    }
+    if (done) break;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+  }
+  _logHandle = nullptr;
+  vTaskDelete(nullptr);
+}
+#endif
+
 #endif // NTRIP_CLIENT_ENABLE_TASK
 
 // ─── Task entry and main loop ───────────────────────────────────────────────
 
 void NtripClient::taskEntry(void* arg) {
-  static_cast<NtripClient*>(arg)->taskLoop();
+  NtripClient* self = static_cast<NtripClient*>(arg);
+  // xTaskCreateStaticPinnedToCore() only returns the handle after the task
+  // may already be running on the other core; logf() needs it from the
+  // first line on to route this task's logs to the queue.
+#if NTRIP_CLIENT_ENABLE_TASK
+  self->_taskHandle = xTaskGetCurrentTaskHandle();
+#endif
+  self->taskLoop();
 }
 
 void NtripClient::taskLoop() {
   RtcmParser parser;
-  StreamPhase phase = StreamPhase::VALIDATION;
-
-  uint8_t* buffer = new uint8_t[config.bufferSize];
-  if (buffer == nullptr) {
-    NTRIP_LOGE("Buffer allocation failed");
-#if NTRIP_CLIENT_ENABLE_TASK
-    _taskHandle = nullptr;
-    vTaskDelete(nullptr);
-#endif
-    return;
+  StreamContext ctx;
+  ctx.self = this;
+  ctx.parser = &parser;
+
+  // Receive buffer at the front of the work area (startTask()), the replay
+  // cache behind the output ring. The cache itself is task-owned.
+  uint8_t* buffer = workArea;
+  RtcmFrameCache cache;
+  if (config.frameCacheSize > 0) {
+    cache.begin(workArea + config.bufferSize + config.outputRingSize, config.frameCacheSize);
+    ctx.cache = &cache;
+  }
+  if (profileValid && ctx.cache != nullptr && profile.framesLen > 0) {
+    const size_t restored = cache.restore(profile.frames, profile.framesLen, millis());
+    NTRIP_LOGD("Restored %u station frames from profile", (unsigned)restored);
   }
 
-  uint8_t validFrames = 0;
-  unsigned long lastSampleTime = 0;
-  unsigned long phaseStartTime = 0;
-
-  // Local stats accumulators — flushed periodically to reduce mutex contention.
-  uint32_t localBytes = 0;
-  uint32_t localFrames = 0;
-  uint32_t localCrcErrors = 0;
-  uint16_t localLastMsgType = 0;
-  unsigned long localLastFrameTime = 0;
   unsigned long lastStatsFlush = 0;
 
   while (_running) {
@@ -152,59 +724,59 @@ void NtripClient::taskLoop() {
         client.stop();
         _healthy = false;
       }
+      abortConnect();
+      dropStandby();
     }
 
-    // ── DISCONNECTED: wait for retry window, then attempt connection ─────
+    // ── DISCONNECTED: wait for the scheduled retry, then connect ─────────
     if (_state == NtripState::DISCONNECTED) {
-      if (millis() - lastAttempt < config.retryDelayMs) {
-        vTaskDelay(pdMS_TO_TICKS(200));
-        continue;
+      if (!retryScheduled) {
+        if (!retry.schedule(failures, millis(), lastAttempt)) {
+          setError(NtripError::MAX_RETRIES_EXCEEDED, "Failed %u times", failures);
+          _state = NtripState::LOCKED_OUT;
+          continue;
+        }
+        retryScheduled = true;
+        if (retry.probing() && failures == config.maxTries) {
+          setError(NtripError::MAX_RETRIES_EXCEEDED, "Failed %u times, probing every %lus",
+                   failures, (unsigned long)(config.probeIntervalMs / 1000));
+        }
+        if (!skipRetryDelay && lastAttempt != 0) {
+          NTRIP_LOGD("Next attempt in %lu ms", (unsigned long)retry.waitMs());
+        }
+        if (lockStats(portMAX_DELAY)) {
+          _stats.retryWaitMs = retry.waitMs();
+          unlockStats();
+        }
       }
-      if (failures >= config.maxTries) {
-        setError(NtripError::MAX_RETRIES_EXCEEDED,
-                 String("Failed ") + failures + " times");
-        _state = NtripState::LOCKED_OUT;
+      // lastAttempt == 0: first connect, or reconnect() asked for one now.
+      if (!skipRetryDelay && lastAttempt != 0 && !retry.due(millis())) {
+        vTaskDelay(pdMS_TO_TICKS(min<unsigned long>(200, retry.remaining(millis()))));
         continue;
       }
+      if (retry.probing() && lockStats(portMAX_DELAY)) {
+        _stats.probes++;
+        unlockStats();
+      }
+      retryScheduled = false;
       _state = NtripState::CONNECTING;
     }
 
-    // ── CONNECTING: TCP + HTTP handshake ─────────────────────────────────
+    // ── CONNECTING: one non-blocking handshake step per iteration ────────
     if (_state == NtripState::CONNECTING) {
-      lastAttempt = millis();
-      NTRIP_LOGI("Connecting to %s:%d/%s (attempt %d/%d)",
-            config.host.c_str(), config.port, config.mount.c_str(),
-            failures + 1, config.maxTries);
-
-      if (connectCaster(config)) {
-        failures = 0;
-        parser.reset();
-        validFrames = 0;
-        phase = StreamPhase::VALIDATION;
-        phaseStartTime = millis();
-        lastHealth = millis();
-        _healthy = false;
-        _state = NtripState::STREAMING;
-
-        // Reset local accumulators
-        localBytes = 0;
-        localFrames = 0;
-        localCrcErrors = 0;
-        localLastMsgType = 0;
-        localLastFrameTime = 0;
+      if (primaryHs.step == HandshakeStep::IDLE) startConnect(config);
+
+      size_t leftover = 0;
+      const int step = stepConnect(config, buffer, config.bufferSize, leftover);
+      if (step > 0) {
+        skipRetryDelay = false;
+        startSession(ctx, parser, leftover);
+        ctx.chunked = response.isChunked();
+        ctx.clearLocalStats();
         lastStatsFlush = millis();
-
-        if (xSemaphoreTake(statsMutex, portMAX_DELAY)) {
-          _stats.reconnects++;
-          _stats.connectionStart = millis();
-          _stats.lastError = NtripError::NONE;
-          _stats.lastErrorMessage = "";
-          xSemaphoreGive(statsMutex);
-        }
-
         NTRIP_LOGI("Connected — validating stream");
-      } else {
-        failures++;
+      } else if (step < 0) {
+        nextEndpoint();
         _state = NtripState::DISCONNECTED;
       }
     }
@@ -213,49 +785,61 @@ void NtripClient::taskLoop() {
     if (_state == NtripState::STREAMING) {
       if (!client.connected()) {
         NTRIP_LOGW("Connection lost");
-        setError(NtripError::TCP_CONNECT_FAILED, "Socket closed by " + config.host);
-        disconnect();
+        setError(NtripError::TCP_CONNECT_FAILED, "Socket closed by %s", endpoints[activeEndpoint].host);
+        recordFailure(activeEndpoint, NtripError::TCP_CONNECT_FAILED);
+        sessionLost(ctx, parser);
         continue;
       }
 
-      int n = client.read(buffer, config.bufferSize);
-      if (n > 0) {
-        localBytes += n;
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+      const uint32_t loopStartUs = latencyNowUs();
+#endif
 
-        // Forward to GNSS immediately
-        if (gnssOutput) {
-          gnssOutput->write(buffer, n);
+      const size_t carry = config.frameAlignedOutput ? ctx.carry : 0;
+      int n;
+      if (ctx.pendingInput > 0) {
+        // Body bytes that arrived in the same segment as the headers
+        n = (int)ctx.pendingInput;
+        ctx.pendingInput = 0;
+      } else {
+        n = client.read(buffer + carry, config.bufferSize - carry);
+      }
+      ctx.readFull = n > 0 && (size_t)n == config.bufferSize - carry;
+      if (n > 0 && carry + n > ctx.localBufferHighWater) ctx.localBufferHighWater = carry + n;
+
+      if (n > 0 && ctx.chunked) {
+        // Rev2 chunked body: strip chunk framing in place before parse/forward
+        n = (int)ctx.chunks.decode(buffer + carry, n);
+        if (ctx.chunks.failed()) {
+          setError(NtripError::STREAM_VALIDATION_FAILED,
+                   "Malformed chunked encoding from %s", endpoints[activeEndpoint].host);
+          recordFailure(activeEndpoint, NtripError::STREAM_VALIDATION_FAILED);
+          sessionLost(ctx, parser);
+          continue;
         }
+      }
 
-        if (phase == StreamPhase::VALIDATION) {
-          // Strict validation — parse every byte until N valid frames
-          for (int i = 0; i < n; i++) {
-            RtcmResult result = parser.feed(buffer[i]);
-
-            if (result.valid) {
-              validFrames++;
-              lastHealth = millis();
-              localFrames++;
-              localLastMsgType = result.messageType;
-              localLastFrameTime = millis();
-
-              NTRIP_LOGD("Valid RTCM%d (%d/%d)",
-                    result.messageType, validFrames, config.requiredValidFrames);
+      if (n > 0) {
+        ctx.localBytes += n;
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+        ctx.readUs = latencyNowUs();
+#endif
 
-              if (validFrames >= config.requiredValidFrames) {
-                _healthy = true;
-                phase = StreamPhase::STREAMING;
-                lastSampleTime = millis();
-                NTRIP_LOGI("Stream validated (%lu ms)", millis() - phaseStartTime);
-                break;
-              }
-            } else if (result.crcError) {
-              localCrcErrors++;
-            }
-          }
+        if (config.frameAlignedOutput) {
+          // Parse everything, forward whole valid frames only
+          forwardFrameAligned(parser, buffer, n, ctx);
         } else {
-          // Passive sampling — scan for RTCM preamble periodically
-          if (millis() - lastSampleTime > config.passiveSampleMs) {
+          // Forward to GNSS immediately
+          emit(ctx, buffer, n);
+
+          if (ctx.phase != StreamPhase::STREAMING) {
+            // Strict validation — parse the whole read until N valid frames,
+            // or for the whole session in continuous mode
+            ctx.buffer = buffer;
+            ctx.feedOffset = 0;
+            parser.feed(buffer, n, onStreamFrame, &ctx);
+          } else if (millis() - ctx.lastSampleTime > config.passiveSampleMs) {
+            // Passive sampling — scan for RTCM preamble periodically
             bool foundPreamble = false;
             const int scanLimit = min(n, (int)NTRIP_CLIENT_PASSIVE_SCAN_BYTES);
 
@@ -264,8 +848,8 @@ void NtripClient::taskLoop() {
                 foundPreamble = true;
                 lastHealth = millis();
                 _healthy = true;
-                lastSampleTime = millis();
-                localLastFrameTime = millis();
+                ctx.lastSampleTime = millis();
+                ctx.localLastFrameTime = millis();
                 break;
               }
             }
@@ -277,58 +861,186 @@ void NtripClient::taskLoop() {
         }
       }
 
-      // Zombie stream detection
-      if (millis() - lastHealth > config.healthTimeoutMs) {
-        NTRIP_LOGW("Zombie stream detected (%lu ms since valid data)",
-                   millis() - lastHealth);
-        setError(NtripError::ZOMBIE_STREAM_DETECTED,
-                 "No valid RTCM for " + String(config.healthTimeoutMs / 1000) + "s");
-        disconnect();
+      // Cached frames go out at the first frame boundary after validation
+      // (always one in frame-aligned mode) once the station is known.
+      if (ctx.replayPending && (config.frameAlignedOutput || parser.pendingBytes() == 0) &&
+          (ctx.stationId != RtcmFrameCache::NO_STATION ||
+           millis() - ctx.validatedAt >= REPLAY_STATION_WAIT_MS)) {
+        replayCache(ctx);
+      }
+
+      // Persist the session once it has proven itself.
+      if (config.persistProfile && _healthy && !ctx.profileSaved &&
+          millis() - ctx.validatedAt >= PROFILE_SAVE_DELAY_MS) {
+        ctx.profileSaved = true;
+        saveProfile(ctx, true);
       }
+
+      // GGA uplink — due immediately after connect, then every interval
+      if (ctx.ggaTailLen > 0) flushGga(ctx);
+      if (config.ggaIntervalMs > 0 && millis() - ctx.lastGgaTime >= config.ggaIntervalMs) {
+        sendGga(ctx);
+      }
+
+      // Zombie stream detection: no valid frame within healthTimeoutMs (or
+      // the adaptive limit), or (epochStaleIntervals) no MSM epoch for that
+      // many learned intervals
+      const unsigned long silence = millis() - lastHealth;
+      const uint32_t healthLimit = healthLimitMs();
+      const unsigned long epochGap = epochTracker.sinceLastEpoch(millis());
+      const uint32_t epochLimit = epochTracker.stats().intervalMs * config.epochStaleIntervals;
+      const bool epochStale = config.epochTracking && epochLimit > 0 && epochGap > epochLimit;
+      if (silence > healthLimit || epochStale) {
+        if (epochStale) {
+          NTRIP_LOGW("Zombie stream detected (%lu ms since last MSM epoch)", epochGap);
+          setError(NtripError::ZOMBIE_STREAM_DETECTED, "No MSM epoch for %lums", epochGap);
+        } else if (healthLimit < config.healthTimeoutMs) {
+          NTRIP_LOGW("Zombie stream detected (%lu ms since valid data, adaptive limit %lu ms)",
+                     silence, (unsigned long)healthLimit);
+          setError(NtripError::ZOMBIE_STREAM_DETECTED, "No valid RTCM for %lums (expected within %lums)",
+                   silence, (unsigned long)healthLimit);
+        } else {
+          NTRIP_LOGW("Zombie stream detected (%lu ms since valid data)",
+                     millis() - lastHealth);
+          setError(NtripError::ZOMBIE_STREAM_DETECTED, "No valid RTCM for %lus",
+                   (unsigned long)(config.healthTimeoutMs / 1000));
+        }
+        recordFailure(activeEndpoint, NtripError::ZOMBIE_STREAM_DETECTED);
+        if (config.persistProfile && profileValid && profile.healthy &&
+            profile.endpoint == activeEndpoint) {
+          saveProfile(ctx, false);
+        }
+        sessionLost(ctx, parser);
+      } else if (endpointCount > 1 && _healthy &&
+                 config.standbyMode != NtripStandbyMode::NONE) {
+        // Prepare the next endpoint only once this one is known good.
+        serviceStandby(config);
+      }
+
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+      if (n > 0) ctx.localLatency.loop.record(latencyNowUs() - loopStartUs);
+#endif
     }
 
     // ── LOCKED_OUT: idle until user calls reset()/reconnect() ────────────
     if (_state == NtripState::LOCKED_OUT) {
+      retryScheduled = false;
       vTaskDelay(pdMS_TO_TICKS(500));
       continue;
     }
 
     // ── Periodic stats flush ─────────────────────────────────────────────
     if (millis() - lastStatsFlush >= STATS_FLUSH_MS) {
-      if (xSemaphoreTake(statsMutex, pdMS_TO_TICKS(10))) {
-        _stats.bytesReceived += localBytes;
-        _stats.totalFrames += localFrames;
-        _stats.crcErrors += localCrcErrors;
-        if (localLastMsgType != 0)    _stats.lastMessageType = localLastMsgType;
-        if (localLastFrameTime != 0)  _stats.lastFrameTime = localLastFrameTime;
+      if (lockStats(pdMS_TO_TICKS(10))) {
+        _stats.bytesReceived += ctx.localBytes;
+        _stats.totalFrames += ctx.localFrames;
+        _stats.crcErrors += ctx.localCrcErrors;
+        _stats.framesFiltered += ctx.localFiltered;
+        _stats.outputOverflows += ctx.localOverflows;
+        _stats.outputDroppedBytes += ctx.localDroppedBytes;
+        _stats.ggaSent += ctx.localGgaSent;
+        _stats.ggaSkipped += ctx.localGgaSkipped;
+        _stats.framesReplayed += ctx.localReplayed;
+        _stats.frameCacheEntries = (uint16_t)cache.size();
+        for (uint8_t i = 0; i < sinkCount; i++) {
+          const SinkSlot& slot = sinkSlots[i];
+          NtripSinkStats& sink = _stats.sinks[i];
+          sink.bytesWritten = slot.bytesWritten.load(std::memory_order_relaxed);
+          sink.overflows = slot.overflows;
+          sink.droppedBytes = slot.droppedBytes + slot.backlogDropped.load(std::memory_order_relaxed);
+          sink.queueHighWater = slot.highWater;
+        }
+#if NTRIP_CLIENT_ENABLE_TASK && NTRIP_CLIENT_LOG_QUEUE_SIZE > 0
+        _stats.logsDropped = logQueue.dropped();
+#endif
+        if (ctx.localRingHighWater > _stats.outputRingHighWater) {
+          _stats.outputRingHighWater = ctx.localRingHighWater;
+        }
+        if (ctx.localBufferHighWater > _stats.bufferHighWater) {
+          _stats.bufferHighWater = ctx.localBufferHighWater;
+        }
+#if NTRIP_CLIENT_ENABLE_TASK
+        _stats.taskStackFree = (uint32_t)uxTaskGetStackHighWaterMark(nullptr);
+        if (_writerHandle != nullptr) {
+          _stats.writerStackFree = (uint32_t)uxTaskGetStackHighWaterMark(_writerHandle);
+        }
+#endif
+        if (ctx.localLastMsgType != 0)    _stats.lastMessageType = ctx.localLastMsgType;
+        if (ctx.localLastFrameTime != 0)  _stats.lastFrameTime = ctx.localLastFrameTime;
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+        _latency.forward.merge(ctx.localLatency.forward);
+        _latency.loop.merge(ctx.localLatency.loop);
+        _latency.writeBlock.merge(ctx.localLatency.writeBlock);
+#endif
         if (_stats.connectionStart > 0) {
           _stats.totalUptime = millis() - _stats.connectionStart;
         }
-        xSemaphoreGive(statsMutex);
+        if (_state == NtripState::STREAMING) {
+          _stats.endpoints[activeEndpoint].uptimeMs += millis() - lastStatsFlush;
+        }
+        _stats.standbyBytes += standbyLocalBytes;
+        if (config.epochTracking) _stats.epochs = epochTracker.stats();
+        _stats.healthLimitMs = healthLimitMs();
+        unlockStats();
 
-        localBytes = 0;
-        localFrames = 0;
-        localCrcErrors = 0;
-        localLastMsgType = 0;
-        localLastFrameTime = 0;
+        ctx.clearLocalStats();
+        standbyLocalBytes = 0;
         lastStatsFlush = millis();
       }
     }
 
-    vTaskDelay(pdMS_TO_TICKS(10));
+    if (config.eventDrivenReads && _state == NtripState::STREAMING) {
+      // Sleep until the socket is readable or the next stats/health deadline.
+      if (!ctx.readFull) {
+        const unsigned long now = millis();
+        const unsigned long sinceFlush = now - lastStatsFlush;
+        const unsigned long sinceHealth = now - lastHealth;
+        const uint32_t healthLimit = healthLimitMs();
+        unsigned long timeout = sinceFlush < STATS_FLUSH_MS ? STATS_FLUSH_MS - sinceFlush : 0;
+        if (sinceHealth < healthLimit) {
+          timeout = min(timeout, (unsigned long)(healthLimit - sinceHealth));
+        } else {
+          timeout = 0;
+        }
+        if (config.epochTracking && config.epochStaleIntervals > 0) {
+          const unsigned long gap = epochTracker.sinceLastEpoch(now);
+          const uint32_t limit = epochTracker.stats().intervalMs * config.epochStaleIntervals;
+          if (limit > 0 && gap > 0) timeout = gap < limit ? min(timeout, (unsigned long)(limit - gap)) : 0;
+        }
+        if (config.ggaIntervalMs > 0) {
+          const unsigned long sinceGga = now - ctx.lastGgaTime;
+          timeout = sinceGga < config.ggaIntervalMs
+              ? min(timeout, (unsigned long)(config.ggaIntervalMs - sinceGga)) : 0;
+          if (ctx.ggaTailLen > 0) timeout = min(timeout, 10UL);
+        }
+        waitReadable(timeout);
+      }
+    } else if (_state == NtripState::CONNECTING) {
+      waitHandshake(10);
+    } else {
+      vTaskDelay(pdMS_TO_TICKS(10));
+    }
   }
 
   // ── Cleanup on exit ────────────────────────────────────────────────────
 
   // Flush remaining local stats
-  if (xSemaphoreTake(statsMutex, pdMS_TO_TICKS(100))) {
-    _stats.bytesReceived += localBytes;
-    _stats.totalFrames += localFrames;
-    _stats.crcErrors += localCrcErrors;
-    xSemaphoreGive(statsMutex);
+  if (lockStats(pdMS_TO_TICKS(100))) {
+    _stats.bytesReceived += ctx.localBytes;
+    _stats.totalFrames += ctx.localFrames;
+    _stats.crcErrors += ctx.localCrcErrors;
+    _stats.framesFiltered += ctx.localFiltered;
+    _stats.outputOverflows += ctx.localOverflows;
+    _stats.outputDroppedBytes += ctx.localDroppedBytes;
+    _stats.ggaSent += ctx.localGgaSent;
+    _stats.ggaSkipped += ctx.localGgaSkipped;
+    _stats.framesReplayed += ctx.localReplayed;
+    unlockStats();
   }
 
-  delete[] buffer;
+  cache.begin(nullptr, 0);
+  abortConnect();
+  dropStandby();
   disconnect();
 
 #if NTRIP_CLIENT_ENABLE_TASK
@@ -337,131 +1049,907 @@ void NtripClient::taskLoop() {
 #endif
 }
 
-// ─── Connection ─────────────────────────────────────────────────────────────
+void NtripClient::startSession(StreamContext& ctx, RtcmParser& parser, size_t leftover) {
+  // Fresh per-connection state; unflushed local counters carry over.
+  parser.reset();
+  ctx.carry = 0;
+  ctx.pendingInput = leftover;
+  ctx.chunked = false;
+  ctx.chunks.reset();
+  config.messageFilter.resetTiming();
+  epochTracker.resetTiming();
+  healthModel.reset();
+  ctx.validFrames = 0;
+  ctx.phase = StreamPhase::VALIDATION;
+  ctx.stationId = RtcmFrameCache::NO_STATION;
+  ctx.trustedStation = profileValid && profile.healthy && profile.endpoint == activeEndpoint
+      ? profile.stationId : RtcmFrameCache::NO_STATION;
+  ctx.profileSaved = false;
+  ctx.replayPending = false;
+  endpoints[activeEndpoint].cache.fromProfile = false;
+  ctx.phaseStartTime = millis();
+  ctx.lastGgaTime = millis() - config.ggaIntervalMs;
+  ctx.ggaTailLen = 0;
+  lastHealth = millis();
+  _healthy = false;
+  _state = NtripState::STREAMING;
 
-bool NtripClient::connectCaster(const NtripClientConfig& cfg) {
-  NtripError err = NtripError::NONE;
-  String errMsg;
+  if (lockStats(portMAX_DELAY)) {
+    _stats.reconnects++;
+    _stats.connectionStart = millis();
+    _stats.lastError = NtripError::NONE;
+    _stats.lastErrorMessage[0] = '\0';
+    unlockStats();
+  }
+}
 
-  if (connectCasterWithVersion(cfg, true, err, errMsg)) {
-    if (statsMutex != nullptr && xSemaphoreTake(statsMutex, portMAX_DELAY)) {
-      _stats.protocolVersion = 2;
-      xSemaphoreGive(statsMutex);
-    }
+bool NtripClient::onStreamFrame(const RtcmResult& frame, size_t endOffset, void* arg) {
+  StreamContext& ctx = *static_cast<StreamContext*>(arg);
+  NtripClient& self = *ctx.self;
+
+  if (frame.crcError) {
+    ctx.localCrcErrors++;
     return true;
   }
 
-#if NTRIP_CLIENT_ENABLE_REV1_FALLBACK
-  NTRIP_LOGW("Rev2 failed, falling back to Rev1");
-  if (connectCasterWithVersion(cfg, false, err, errMsg)) {
-    if (statsMutex != nullptr && xSemaphoreTake(statsMutex, portMAX_DELAY)) {
-      _stats.protocolVersion = 1;
-      xSemaphoreGive(statsMutex);
+  unsigned long now = millis();
+
+  if (self.config.epochTracking &&
+      self.epochTracker.onFrame(frame.messageType, ctx.parser->header(),
+                                min<size_t>(frame.length, (size_t)RtcmParser::HEADER_BYTES), now)) {
+    self.refreshTimeReference();
+  }
+  if (self.config.adaptiveHealth) self.healthModel.onFrame(frame.messageType, now);
+
+  if (ctx.stationId == RtcmFrameCache::NO_STATION && RtcmFrame::hasStationId(frame.messageType)) {
+    const RtcmBitReader bits(ctx.parser->header(), min<size_t>(frame.length, (size_t)RtcmParser::HEADER_BYTES));
+    if (bits.fits(12, 12)) ctx.stationId = (uint16_t)bits.getUnsigned(12, 12);
+  }
+  if (ctx.cache != nullptr && RtcmFrameCache::isCacheable(frame.messageType)) {
+    // In raw mode a frame that began in an earlier read is not contiguous;
+    // skip it, the caster sends it again.
+    const size_t end = ctx.feedOffset + endOffset;
+    const size_t frameLen = frame.length + RtcmParser::FRAME_OVERHEAD;
+    if (end >= frameLen) ctx.cache->store(ctx.buffer + end - frameLen, frameLen, now);
+  }
+
+  if (self.config.frameAlignedOutput) {
+    // Extend the pending run if this frame directly follows it; a filtered
+    // frame breaks the run so it is never written.
+    const size_t end = ctx.feedOffset + endOffset;
+    const size_t start = end - (frame.length + RtcmParser::FRAME_OVERHEAD);
+    if (self.frameFn != nullptr) {
+      self.frameFn(RtcmFrame(ctx.buffer + start, end - start), self.frameCtx);
     }
-    return true;
+    if (!self.config.messageFilter.accept(frame.messageType, now)) {
+      ctx.localFiltered++;
+    } else if (start != ctx.spanEnd) {
+      self.emit(ctx, ctx.buffer + ctx.spanStart, ctx.spanEnd - ctx.spanStart);
+      ctx.spanStart = start;
+      ctx.spanEnd = end;
+    } else {
+      ctx.spanEnd = end;
+    }
+  }
+
+  self.lastHealth = now;
+  ctx.localFrames++;
+  ctx.localLastMsgType = frame.messageType;
+  ctx.localLastFrameTime = now;
+
+  // Continuous mode: counters only, no per-frame logging on the hot path.
+  if (ctx.phase == StreamPhase::CONTINUOUS) return true;
+
+  // A frame from the station the profile recorded as healthy is enough.
+  if (ctx.trustedStation != RtcmFrameCache::NO_STATION && ctx.stationId == ctx.trustedStation &&
+      ctx.validFrames + 1 < self.config.requiredValidFrames) {
+    ctx.validFrames = self.config.requiredValidFrames - 1;
+    NTRIP_LOG_AT(self, Debug, "Station %u matches profile", ctx.stationId);
+  }
+  ctx.validFrames++;
+  NTRIP_LOG_AT(self, Debug, "Valid RTCM%d (%d/%d)",
+            frame.messageType, ctx.validFrames, self.config.requiredValidFrames);
+
+  if (ctx.validFrames >= self.config.requiredValidFrames) {
+    // Only a validated stream clears the failure count; a 200 alone does not.
+    self.failures = 0;
+    self.cycleAttempts = 0;
+    self._healthy = true;
+    ctx.lastSampleTime = now;
+    ctx.validatedAt = now;
+    ctx.replayPending = ctx.cache != nullptr && ctx.cache->size() > 0;
+    NTRIP_LOG_AT(self, Info, "Stream validated (%lu ms)",
+              now - ctx.phaseStartTime);
+    if (self.config.continuousValidation || self.config.frameAlignedOutput) {
+      ctx.phase = StreamPhase::CONTINUOUS;
+      return true;
+    }
+    ctx.phase = StreamPhase::STREAMING;
+    return false;
+  }
+  return true;
+}
+
+void NtripClient::replayCache(StreamContext& ctx) {
+  ctx.replayPending = false;
+  const uint32_t before = ctx.localReplayed;
+  ctx.cache->replay(replayWrite, &ctx, ctx.stationId, config.frameCacheMaxAgeMs, millis());
+  if (ctx.localReplayed != before) {
+    NTRIP_LOGI("Replayed %lu cached frames", (unsigned long)(ctx.localReplayed - before));
+  }
+}
+
+void NtripClient::replayWrite(const uint8_t* frame, size_t len, void* arg) {
+  StreamContext& ctx = *static_cast<StreamContext*>(arg);
+  const uint16_t type = (uint16_t)(frame[3] << 4 | frame[4] >> 4);
+  // Denied types stay denied; decimation does not apply to a one-off replay.
+  if (!ctx.self->config.messageFilter.allows(type)) return;
+  ctx.self->emit(ctx, frame, len);
+  ctx.localReplayed++;
+}
+
+void NtripClient::forwardFrameAligned(RtcmParser& parser, uint8_t* buffer,
+                                      size_t n, StreamContext& ctx) {
+  // Bytes [0, carry) hold the start of a frame from the previous read; the
+  // new bytes follow it, so every completed frame is contiguous in buffer
+  // and can be written straight out of it.
+  ctx.buffer = buffer;
+  ctx.feedOffset = ctx.carry;
+  ctx.spanStart = ctx.spanEnd = 0;
+
+  parser.feed(buffer + ctx.carry, n, onStreamFrame, &ctx);
+
+  emit(ctx, buffer + ctx.spanStart, ctx.spanEnd - ctx.spanStart);
+
+  // Move the trailing partial frame (if any) to the front for the next read.
+  const size_t total = ctx.carry + n;
+  const size_t pending = parser.pendingBytes();
+  if (pending > 0 && pending < total) {
+    memmove(buffer, buffer + total - pending, pending);
+  }
+  ctx.carry = pending;
+}
+
+void NtripClient::emit(StreamContext& ctx, const uint8_t* data, size_t len) {
+  // Single exit point for corrections: direct write, or hand-off to the
+  // writer task through the SPSC ring.
+  if (gnssOutput == nullptr || len == 0) return;
+  if (sinkCount > 0) emitSinks(data, len, true);
+
+#if NTRIP_CLIENT_ENABLE_TASK
+  if (_writerHandle != nullptr) {
+    if (outputRing.push(data, len)) {
+      const uint32_t fill = outputRing.size();
+      if (fill > ctx.localRingHighWater) ctx.localRingHighWater = fill;
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+      // Sample one chunk at a time; the writer records it when it reaches it.
+      if (!latencyMarkArmed.load(std::memory_order_acquire)) {
+        latencyMarkUs = ctx.readUs;
+        latencyMarkPos = outputRing.pushedTotal();
+        latencyMarkArmed.store(true, std::memory_order_release);
+      }
+#endif
+      xTaskNotifyGive(_writerHandle);
+    } else {
+      ctx.localOverflows++;
+      ctx.localDroppedBytes += len;
+    }
+    if (sinkCount > 0) emitSinks(data, len, false);
+    return;
   }
 #endif
 
-  setError(err, errMsg);
-  return false;
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+  const uint32_t t0 = latencyNowUs();
+  ctx.localLatency.forward.record(t0 - ctx.readUs);
+  gnssOutput->write(data, len);
+  ctx.localLatency.writeBlock.record(latencyNowUs() - t0);
+#else
+  (void)ctx;
+  gnssOutput->write(data, len);
+#endif
+  if (sinkCount > 0) emitSinks(data, len, false);
 }
 
-bool NtripClient::connectCasterWithVersion(const NtripClientConfig& cfg,
-                                           bool useRev2,
-                                           NtripError& err,
-                                           String& errMsg) {
-  if (!client.connect(cfg.host.c_str(), cfg.port, cfg.connectTimeoutMs)) {
-    err = NtripError::TCP_CONNECT_FAILED;
-    errMsg = "Cannot reach " + cfg.host + ":" + cfg.port;
-    return false;
+void NtripClient::emitSinks(const uint8_t* data, size_t len, bool queued) {
+  // Queued sinks go first (a copy into their ring); inline sinks after the
+  // GNSS output, straight from the receive buffer.
+  for (uint8_t i = 0; i < sinkCount; i++) {
+    SinkSlot& slot = sinkSlots[i];
+    if (slot.queued != queued) continue;
+    if (!queued) {
+      slot.output->write(data, len);
+      slot.bytesWritten.fetch_add((uint32_t)len, std::memory_order_relaxed);
+      continue;
+    }
+#if NTRIP_CLIENT_ENABLE_TASK
+    if (slot.handle == nullptr) continue;
+    if (slot.ring.push(data, len)) {
+      const uint32_t fill = slot.ring.size();
+      if (fill > slot.highWater) slot.highWater = fill;
+    } else {
+      slot.overflows++;
+      slot.droppedBytes += len;
+      if (slot.dropPolicy == NtripDropPolicy::DROP_BACKLOG) {
+        slot.discardTo.store(slot.ring.pushedTotal(), std::memory_order_relaxed);
+        slot.discard.store(true, std::memory_order_release);
+      }
+    }
+    xTaskNotifyGive(slot.handle);
+#endif
+  }
+}
+
+void NtripClient::sendGga(StreamContext& ctx) {
+  ctx.lastGgaTime = millis();
+
+  NtripPosition pos;
+  unsigned long fixMs;
+  const bool have = readPosition(pos, fixMs);
+  // The previous sentence still going out also drops this update: a new
+  // line must not be spliced into it.
+  const size_t len = have && pos.valid && ctx.ggaTailLen == 0
+      ? NmeaGga::build(pos, ctx.ggaTail, sizeof(ctx.ggaTail)) : 0;
+  if (len == 0 || client.fd() < 0) {
+    ctx.localGgaSkipped++;
+    return;
+  }
+  ctx.ggaTailLen = (uint8_t)len;
+  flushGga(ctx);
+}
+
+void NtripClient::flushGga(StreamContext& ctx) {
+  // Never block the receive path: send what the socket takes now and the
+  // rest on later iterations. Counted as sent once the whole line is out.
+  const int fd = client.fd();
+  const int n = fd >= 0 ? send(fd, ctx.ggaTail, ctx.ggaTailLen, MSG_DONTWAIT) : -1;
+  if (n < 0) {
+    if (fd >= 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+    ctx.ggaTailLen = 0;  // Socket gone; the loop sees !connected()
+    ctx.localGgaSkipped++;
+    return;
+  }
+  if ((size_t)n < ctx.ggaTailLen) {
+    memmove(ctx.ggaTail, ctx.ggaTail + n, ctx.ggaTailLen - n);
+    ctx.ggaTailLen -= (uint8_t)n;
+    return;
   }
+  ctx.ggaTailLen = 0;
+  ctx.localGgaSent++;
+}
 
-  String auth = base64::encode(cfg.user + ":" + cfg.pass);
+void NtripClient::waitReadable(uint32_t timeoutMs) {
+  // Bytes already buffered inside WiFiClient are invisible to select().
+  if (client.available() > 0) return;
 
-  // Build NTRIP request
-  client.print("GET /");
-  client.print(cfg.mount);
-  if (useRev2) {
-    client.print(" HTTP/1.1\r\n");
+  const int fd = client.fd();
+  if (fd < 0) {
+    vTaskDelay(pdMS_TO_TICKS(10));
+    return;
+  }
+
+  fd_set readSet;
+  FD_ZERO(&readSet);
+  FD_SET(fd, &readSet);
+  struct timeval tv;
+  tv.tv_sec = timeoutMs / 1000;
+  tv.tv_usec = (timeoutMs % 1000) * 1000;
+
+  // Readable also covers peer close/error; the loop then sees !connected().
+  if (select(fd + 1, &readSet, nullptr, nullptr, &tv) < 0) {
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+}
+
+// ─── Connection ─────────────────────────────────────────────────────────────
+// CONNECTING is driven by stepConnect() once per taskLoop iteration. Each
+// socket's handshake (DNS → TCP_CONNECTING → REQUEST_SENT → HEADERS) runs on
+// a raw non-blocking lwIP socket, handed to a WiFiClient once accepted.
+
+void NtripClient::startConnect(const NtripClientConfig& cfg) {
+  lastAttempt = millis();
+  connectStart = millis();
+  const EndpointSlot& ep = endpoints[activeEndpoint];
+  if (failures >= cfg.maxTries) {
+    NTRIP_LOGI("Probing %s:%d/%s (%d failures)", ep.host, ep.port, ep.mount, failures);
   } else {
-    client.print(" HTTP/1.0\r\n");
+    NTRIP_LOGI("Connecting to %s:%d/%s (attempt %d/%d)",
+          ep.host, ep.port, ep.mount, failures + 1, cfg.maxTries);
   }
 
-  client.print("User-Agent: NTRIP ESP32 v");
-  client.print(NTRIP_CLIENT_VERSION);
-  client.print("\r\n");
+  // Revision that worked last time for this caster (0 = unknown).
+  const uint8_t known = cfg.rememberProtocol || ep.cache.fromProfile ? ep.cache.version : 0;
+#if NTRIP_CLIENT_ENABLE_REV1_FALLBACK
+  connectRacing = cfg.raceProtocols && known == 0;
+  connectFallbackPending = !connectRacing;
+  beginHandshake(primaryHs, activeEndpoint, known != 1);
+  if (connectRacing) beginHandshake(rivalHs, activeEndpoint, false);
+#else
+  (void)known;
+  beginHandshake(primaryHs, activeEndpoint, true);
+#endif
+}
+
+int NtripClient::stepConnect(const NtripClientConfig& cfg, uint8_t* buffer,
+                             size_t cap, size_t& leftover) {
+  Handshake* winner = nullptr;
+  leftover = 0;
 
-  if (useRev2) {
-    client.print("Host: ");
-    client.print(cfg.host);
-    client.print("\r\n");
-    client.print("Ntrip-Version: Ntrip/2.0\r\n");
+  stepHandshake(cfg, primaryHs, buffer, cap);
+  if (primaryHs.step == HandshakeStep::DONE) {
+    winner = &primaryHs;
+    leftover = primaryHs.leftover;
   }
 
-  client.print("Authorization: Basic ");
-  client.print(auth);
-  client.print("\r\n");
+#if NTRIP_CLIENT_ENABLE_REV1_FALLBACK
+  if (connectRacing) {
+    // Rev2 on the primary, Rev1 on the rival; first 200 wins. The rival's
+    // head is read through scratch and its body bytes moved to buffer.
+    uint8_t scratch[NTRIP_CLIENT_LINE_LEN];
+    if (winner == nullptr) {
+      stepHandshake(cfg, rivalHs, scratch, sizeof(scratch));
+      if (rivalHs.step == HandshakeStep::DONE) {
+        winner = &rivalHs;
+        memcpy(buffer, scratch, rivalHs.leftover);
+        leftover = rivalHs.leftover;
+      }
+    }
+    if (winner != nullptr) {
+      abortHandshake(winner == &primaryHs ? rivalHs : primaryHs);
+      NTRIP_LOGI("Rev%d won the handshake race", winner->rev2 ? 2 : 1);
+    } else if (primaryHs.step == HandshakeStep::FAILED &&
+               rivalHs.step == HandshakeStep::FAILED) {
+      // Report whichever head arrived, Rev2 first.
+      if (primaryHs.response.status() == NtripResponseStatus::PENDING &&
+          rivalHs.response.status() != NtripResponseStatus::PENDING) {
+        primaryHs.err = rivalHs.err;
+        memcpy(primaryHs.errMsg, rivalHs.errMsg, sizeof(primaryHs.errMsg));
+      }
+    } else {
+      return 0;
+    }
+  } else if (primaryHs.step == HandshakeStep::FAILED && connectFallbackPending &&
+             primaryHs.err != NtripError::TCP_CONNECT_FAILED) {
+    // Once the request is out, an error status, a close or a timeout may
+    // be a caster that speaks only the other revision. DNS and TCP connect
+    // failures (unreachable caster) go straight to the next attempt.
+    connectFallbackPending = false;
+    const bool rev2 = !primaryHs.rev2;
+    NTRIP_LOGW("Rev%d failed, falling back to Rev%d", rev2 ? 1 : 2, rev2 ? 2 : 1);
+    beginHandshake(primaryHs, activeEndpoint, rev2);
+    return 0;
+  }
+#endif
 
-  if (useRev2 && cfg.ggaSentence.length() > 0) {
-    client.print("Ntrip-GGA: ");
-    client.print(cfg.ggaSentence);
-    client.print("\r\n");
+  EndpointSlot& ep = endpoints[activeEndpoint];
+  if (winner != nullptr) {
+    const uint8_t version = winner->rev2 ? 2 : 1;
+    response = winner->response;
+    adoptHandshake(*winner, client);
+    ep.cache.version = version;
+    recordConnect(activeEndpoint, millis() - connectStart);
+    if (lockStats(portMAX_DELAY)) {
+      _stats.protocolVersion = version;
+      _stats.activeEndpoint = activeEndpoint;
+      unlockStats();
+    }
+    return 1;
   }
 
-  client.print("\r\n");
+  if (primaryHs.step != HandshakeStep::FAILED) return 0;
 
-  // Wait for response
-  unsigned long start = millis();
-  while (!client.available() && millis() - start < cfg.connectTimeoutMs) {
-    vTaskDelay(pdMS_TO_TICKS(10));
+  ep.cache.version = 0;
+  ep.cache.fromProfile = false;
+  primaryHs.step = HandshakeStep::IDLE;
+#if NTRIP_CLIENT_ENABLE_REV1_FALLBACK
+  rivalHs.step = HandshakeStep::IDLE;
+#endif
+  recordFailure(activeEndpoint, primaryHs.err);
+  setError(primaryHs.err, "%s", primaryHs.errMsg);
+  return -1;
+}
+
+void NtripClient::abortConnect() {
+  abortHandshake(primaryHs);
+#if NTRIP_CLIENT_ENABLE_REV1_FALLBACK
+  abortHandshake(rivalHs);
+#endif
+}
+
+void NtripClient::waitHandshake(uint32_t timeoutMs) {
+  // Sleep until a handshake socket makes progress, or timeoutMs.
+  fd_set readSet;
+  fd_set writeSet;
+  FD_ZERO(&readSet);
+  FD_ZERO(&writeSet);
+  int maxFd = -1;
+
+  const Handshake* active[] = {
+    &primaryHs,
+#if NTRIP_CLIENT_ENABLE_REV1_FALLBACK
+    &rivalHs,
+#endif
+  };
+  for (const Handshake* hs : active) {
+    if (hs->fd < 0) continue;
+    FD_SET(hs->fd, hs->step == HandshakeStep::TCP_CONNECTING ? &writeSet : &readSet);
+    if (hs->fd > maxFd) maxFd = hs->fd;
   }
 
-  if (!client.available()) {
-    client.stop();
-    err = NtripError::HTTP_TIMEOUT;
-    errMsg = "No response from " + cfg.host;
-    return false;
+  if (maxFd < 0) {
+    vTaskDelay(pdMS_TO_TICKS(timeoutMs));
+    return;
   }
+  struct timeval tv;
+  tv.tv_sec = timeoutMs / 1000;
+  tv.tv_usec = (timeoutMs % 1000) * 1000;
+  if (select(maxFd + 1, &readSet, &writeSet, nullptr, &tv) < 0) {
+    vTaskDelay(pdMS_TO_TICKS(timeoutMs));
+  }
+}
 
-  String line = client.readStringUntil('\n');
-  line.trim();
+// ─── Handshake state machine ────────────────────────────────────────────────
+
+void NtripClient::beginHandshake(Handshake& hs, uint8_t endpoint, bool rev2) {
+  abortHandshake(hs);
+  hs.step = HandshakeStep::DNS;
+  hs.endpoint = endpoint;
+  hs.rev2 = rev2;
+  hs.sent = 0;
+  hs.leftover = 0;
+  hs.start = millis();
+  hs.response.reset();
+  hs.err = NtripError::NONE;
+  hs.errMsg[0] = '\0';
+}
 
-  NTRIP_LOGI("Response: %s", line.c_str());
+void NtripClient::stepHandshake(const NtripClientConfig& cfg, Handshake& hs,
+                                uint8_t* buf, size_t cap) {
+  EndpointSlot& ep = endpoints[hs.endpoint];
+
+  // TCP connect + request + response head share one deadline.
+  if (hs.step > HandshakeStep::DNS && hs.step < HandshakeStep::DONE &&
+      millis() - hs.start >= cfg.connectTimeoutMs) {
+    if (hs.step == HandshakeStep::TCP_CONNECTING) {
+      ep.cache.ipValid = false;
+      failHandshake(hs, NtripError::TCP_CONNECT_FAILED, "Cannot reach %s:%u", ep.host, ep.port);
+    } else {
+      failHandshake(hs, NtripError::HTTP_TIMEOUT, "No response from %s", ep.host);
+    }
+    return;
+  }
 
-  if (line.startsWith("ICY 200") || line.startsWith("HTTP/1.1 200") ||
-      line.startsWith("HTTP/1.0 200")) {
-    // Drain HTTP headers before binary stream begins
-    unsigned long drainStart = millis();
-    while (millis() - drainStart < cfg.connectTimeoutMs) {
-      if (client.available()) {
-        String header = client.readStringUntil('\n');
-        header.trim();
-        if (header.length() == 0) {
-          NTRIP_LOGI("Headers drained, binary stream starting");
-          return true;
+  switch (hs.step) {
+    case HandshakeStep::DNS: {
+      // The one step that can block: a DNS miss (dnsCacheTtlMs avoids it).
+      IPAddress ip;
+      if (!resolveCaster(cfg, ep, ip)) {
+        failHandshake(hs, NtripError::TCP_CONNECT_FAILED, "Cannot resolve %s", ep.host);
+        return;
+      }
+      hs.fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+      if (hs.fd < 0) {
+        failHandshake(hs, NtripError::TCP_CONNECT_FAILED, "No socket for %s", ep.host);
+        return;
+      }
+      fcntl(hs.fd, F_SETFL, fcntl(hs.fd, F_GETFL, 0) | O_NONBLOCK);
+      int one = 1;
+      setsockopt(hs.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+      struct sockaddr_in addr;
+      memset(&addr, 0, sizeof(addr));
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(ep.port);
+      addr.sin_addr.s_addr = (uint32_t)ip;
+      if (connect(hs.fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 && errno != EINPROGRESS) {
+        ep.cache.ipValid = false;
+        failHandshake(hs, NtripError::TCP_CONNECT_FAILED, "Cannot reach %s:%u", ep.host, ep.port);
+        return;
+      }
+      hs.start = millis();
+      hs.step = HandshakeStep::TCP_CONNECTING;
+      return;
+    }
+
+    case HandshakeStep::TCP_CONNECTING: {
+      fd_set writeSet;
+      FD_ZERO(&writeSet);
+      FD_SET(hs.fd, &writeSet);
+      struct timeval tv = {0, 0};
+      if (select(hs.fd + 1, nullptr, &writeSet, nullptr, &tv) <= 0) return;
+
+      int soErr = 0;
+      socklen_t len = sizeof(soErr);
+      if (getsockopt(hs.fd, SOL_SOCKET, SO_ERROR, &soErr, &len) < 0 || soErr != 0) {
+        // A stale address is the likeliest cause — re-resolve next attempt.
+        ep.cache.ipValid = false;
+        failHandshake(hs, NtripError::TCP_CONNECT_FAILED, "Cannot reach %s:%u", ep.host, ep.port);
+        return;
+      }
+      hs.step = HandshakeStep::REQUEST_SENT;
+      return;
+    }
+
+    case HandshakeStep::REQUEST_SENT:
+    case HandshakeStep::HEADERS: {
+      // Send the request pre-serialized in begin(), normally as one segment
+      const char* request = ep.requestRev2;
+      size_t requestLen = ep.requestRev2Len;
+#if NTRIP_CLIENT_ENABLE_REV1_FALLBACK
+      if (!hs.rev2) {
+        request = ep.requestRev1;
+        requestLen = ep.requestRev1Len;
+      }
+#endif
+      if (hs.sent < requestLen) {
+        const int n = send(hs.fd, request + hs.sent, requestLen - hs.sent, MSG_DONTWAIT);
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+          failHandshake(hs, NtripError::TCP_CONNECT_FAILED, "Request send to %s failed", ep.host);
+          return;
         }
+        if (n > 0) hs.sent += n;
+        if (hs.sent < requestLen) return;
       }
-      vTaskDelay(pdMS_TO_TICKS(10));
+
+      // Response head: read straight into buf; whatever follows the
+      // headers is moved to its front for the stream.
+      const int n = recv(hs.fd, buf, cap, MSG_DONTWAIT);
+      if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        failHandshake(hs, NtripError::HTTP_TIMEOUT, "No response from %s", ep.host);
+        return;
+      }
+      if (n < 0) return;
+
+      hs.step = HandshakeStep::HEADERS;
+      const size_t consumed = hs.response.feed(buf, n);
+      if (!hs.response.done()) return;
+
+      hs.leftover = n - consumed;
+      if (hs.leftover > 0 && consumed > 0) memmove(buf, buf + consumed, hs.leftover);
+      finishResponse(hs);
+      return;
     }
-    NTRIP_LOGW("Header drain timeout, proceeding");
-    return true;
+
+    case HandshakeStep::IDLE:
+    case HandshakeStep::DONE:
+    case HandshakeStep::FAILED:
+      return;
+  }
+}
+
+void NtripClient::finishResponse(Handshake& hs) {
+  const EndpointSlot& ep = endpoints[hs.endpoint];
+  const NtripResponseParser& parser = hs.response;
+  NTRIP_LOGI("Response: %s", parser.statusLine());
+
+  if (parser.isOk()) {
+    NTRIP_LOGI("Headers drained, binary stream starting");
+    if (parser.isChunked()) NTRIP_LOGI("Transfer-Encoding: chunked");
+    if (parser.contentType()[0] != '\0') {
+      NTRIP_LOGD("Content-Type: %s", parser.contentType());
+    }
+    hs.step = HandshakeStep::DONE;
+    return;
   }
 
   // Parse specific HTTP errors
-  client.stop();
+  switch (parser.status()) {
+    case NtripResponseStatus::UNAUTHORIZED:
+      failHandshake(hs, NtripError::HTTP_AUTH_FAILED, "Invalid credentials for %s", ep.host);
+      break;
+    case NtripResponseStatus::NOT_FOUND:
+      failHandshake(hs, NtripError::HTTP_MOUNT_NOT_FOUND, "Mount not found: %s", ep.mount);
+      break;
+    default:
+      failHandshake(hs, NtripError::HTTP_UNKNOWN_ERROR, "HTTP error: %s", parser.statusLine());
+      break;
+  }
+}
+
+void NtripClient::failHandshake(Handshake& hs, NtripError err, const char* fmt, ...) {
+  if (hs.fd >= 0) {
+    close(hs.fd);
+    hs.fd = -1;
+  }
+  hs.step = HandshakeStep::FAILED;
+  hs.err = err;
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(hs.errMsg, sizeof(hs.errMsg), fmt, args);
+  va_end(args);
+}
+
+void NtripClient::adoptHandshake(Handshake& hs, WiFiClient& into) {
+  // WiFiClient expects a blocking socket (its writes wait on select()).
+  fcntl(hs.fd, F_SETFL, fcntl(hs.fd, F_GETFL, 0) & ~O_NONBLOCK);
+  into.stop();
+  into = WiFiClient(hs.fd);
+  hs.fd = -1;
+  hs.step = HandshakeStep::IDLE;
+}
 
-  if (line.indexOf("401") >= 0) {
-    err = NtripError::HTTP_AUTH_FAILED;
-    errMsg = "Invalid credentials for " + cfg.host;
-  } else if (line.indexOf("404") >= 0) {
-    err = NtripError::HTTP_MOUNT_NOT_FOUND;
-    errMsg = "Mount not found: " + cfg.mount;
+void NtripClient::abortHandshake(Handshake& hs) {
+  if (hs.fd >= 0) {
+    close(hs.fd);
+    hs.fd = -1;
+  }
+  hs.step = HandshakeStep::IDLE;
+}
+
+// Address lifetime for endpoints resolved ahead of time when dnsCacheTtlMs
+// is left at 0 but failover standby is enabled.
+static constexpr uint32_t STANDBY_DNS_TTL_MS = 60000;
+
+static uint32_t dnsTtlMs(const NtripClientConfig& cfg) {
+  if (cfg.dnsCacheTtlMs > 0) return cfg.dnsCacheTtlMs;
+  return cfg.alternateCount > 0 && cfg.standbyMode != NtripStandbyMode::NONE
+             ? STANDBY_DNS_TTL_MS : 0;
+}
+
+bool NtripClient::resolveCaster(const NtripClientConfig& cfg, EndpointSlot& ep, IPAddress& ip) {
+  // Serve from cache while fresh (or restored from the profile); otherwise
+  // resolve and restamp.
+  if (ep.cache.ipValid && (ep.cache.fromProfile || millis() - ep.cache.resolvedAt < dnsTtlMs(cfg))) {
+    ip = ep.cache.ip;
+    return true;
+  }
+
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo* res = nullptr;
+  if (getaddrinfo(ep.host, nullptr, &hints, &res) != 0 || res == nullptr) {
+    ep.cache.ipValid = false;
+    return false;
+  }
+  ip = IPAddress(((struct sockaddr_in*)res->ai_addr)->sin_addr.s_addr);
+  freeaddrinfo(res);
+
+  ep.cache.ip = ip;
+  ep.cache.resolvedAt = millis();
+  ep.cache.ipValid = true;
+  return true;
+}
+
+// ─── Failover ───────────────────────────────────────────────────────────────
+
+void NtripClient::nextEndpoint() {
+  // Rotate through the endpoint list; the retry delay (and one failure
+  // toward lockout) only applies once every endpoint has been tried.
+  if (++cycleAttempts < endpointCount) {
+    skipRetryDelay = true;
   } else {
-    err = NtripError::HTTP_UNKNOWN_ERROR;
-    errMsg = "HTTP error: " + line;
+    cycleAttempts = 0;
+    skipRetryDelay = false;
+    if (failures < 0xFF) failures++;
+  }
+  activeEndpoint = (activeEndpoint + 1) % endpointCount;
+}
+
+void NtripClient::sessionLost(StreamContext& ctx, RtcmParser& parser) {
+  // A session that never validated counts as a failed attempt, so a caster
+  // that answers 200 and then closes or sends garbage backs off (and is
+  // not retried at once under fastFirstRetry) like one that refuses.
+  if (failover(ctx, parser)) return;
+  disconnect();
+  if (endpointCount > 1) {
+    nextEndpoint();
+  } else if (ctx.phase == StreamPhase::VALIDATION && failures < 0xFF) {
+    failures++;
+  }
+}
+
+bool NtripClient::failover(StreamContext& ctx, RtcmParser& parser) {
+  // Swap in an authenticated standby within this loop iteration.
+  if (standbyPhase != StandbyPhase::READY) return false;
+
+  const uint8_t from = activeEndpoint;
+  client.stop();
+  client = standby;
+  standby.stop();  // Drops this handle only; client keeps the socket
+  standbyPhase = StandbyPhase::IDLE;
+  standbyStart = millis();
+
+  activeEndpoint = standbyEndpoint;
+  cycleAttempts = 0;
+  skipRetryDelay = false;
+  lastAttempt = millis();
+
+  startSession(ctx, parser, 0);
+  ctx.chunked = standbyHs.response.isChunked();
+  ctx.chunks = standbyChunks;
+
+  if (lockStats(portMAX_DELAY)) {
+    _stats.failovers++;
+    _stats.activeEndpoint = activeEndpoint;
+    _stats.protocolVersion = endpoints[activeEndpoint].cache.version;
+    unlockStats();
+  }
+  NTRIP_LOGI("Failover %s → %s (warm standby)",
+             endpoints[from].host, endpoints[activeEndpoint].host);
+  return true;
+}
+
+void NtripClient::serviceStandby(const NtripClientConfig& cfg) {
+  const uint8_t target = (activeEndpoint + 1) % endpointCount;
+  if (standbyPhase != StandbyPhase::IDLE && standbyEndpoint != target) dropStandby();
+  standbyEndpoint = target;
+  EndpointSlot& ep = endpoints[target];
+
+  if (cfg.standbyMode == NtripStandbyMode::RESOLVED) {
+    // Keep its address fresh so failover skips the DNS round trip.
+    IPAddress ip;
+    if (!(ep.cache.ipValid && millis() - ep.cache.resolvedAt < dnsTtlMs(cfg)) &&
+        (standbyStart == 0 || millis() - standbyStart >= cfg.retryDelayMs)) {
+      standbyStart = millis();
+      if (!resolveCaster(cfg, ep, ip)) NTRIP_LOGW("Standby %s: DNS lookup failed", ep.host);
+    }
+    return;
   }
 
-  return false;
+  uint8_t scratch[NTRIP_CLIENT_LINE_LEN];
+
+  switch (standbyPhase) {
+    case StandbyPhase::IDLE:
+      if (standbyStart != 0 && millis() - standbyStart < cfg.retryDelayMs) return;
+      standbyStart = millis();
+      if (cfg.rememberProtocol && ep.cache.version != 0) standbyRev2 = ep.cache.version == 2;
+      beginHandshake(standbyHs, target, standbyRev2);
+      standbyChunks.reset();
+      standbyPhase = StandbyPhase::HANDSHAKE;
+      return;
+
+    case StandbyPhase::HANDSHAKE:
+      // Advanced one non-blocking step per streaming iteration.
+      stepHandshake(cfg, standbyHs, scratch, sizeof(scratch));
+      if (standbyHs.step == HandshakeStep::DONE) {
+        if (standbyHs.response.isChunked()) standbyChunks.decode(scratch, standbyHs.leftover);
+        standbyLocalBytes += standbyHs.leftover;
+        adoptHandshake(standbyHs, standby);
+        ep.cache.version = standbyRev2 ? 2 : 1;
+        recordConnect(target, millis() - standbyStart);
+        standbyPhase = StandbyPhase::READY;
+        NTRIP_LOGI("Standby ready on %s (Rev%d)", ep.host, standbyRev2 ? 2 : 1);
+        return;
+      }
+      if (standbyHs.step != HandshakeStep::FAILED) return;
+#if NTRIP_CLIENT_ENABLE_REV1_FALLBACK
+      // Alternate revisions between attempts until one succeeds.
+      standbyRev2 = !standbyRev2;
+#endif
+      break;
+
+    case StandbyPhase::READY: {
+      // Discard the idle stream but keep chunk framing in sync for the swap.
+      int n;
+      while ((n = standby.read(scratch, sizeof(scratch))) > 0) {
+        standbyLocalBytes += n;
+        if (standbyHs.response.isChunked()) standbyChunks.decode(scratch, n);
+      }
+      if (standby.connected() && !standbyChunks.failed()) return;
+      standbyHs.err = NtripError::TCP_CONNECT_FAILED;
+      snprintf(standbyHs.errMsg, sizeof(standbyHs.errMsg), "Standby closed by %s", ep.host);
+      break;
+    }
+  }
+
+  // Failure: retry after retryDelayMs from standbyStart.
+  NTRIP_LOGW("Standby %s", standbyHs.errMsg);
+  const NtripError err = standbyHs.err;
+  dropStandby();
+  recordFailure(target, err);
+}
+
+void NtripClient::dropStandby() {
+  abortHandshake(standbyHs);
+  if (standbyPhase == StandbyPhase::READY || standby.connected()) standby.stop();
+  standbyPhase = StandbyPhase::IDLE;
+}
+
+void NtripClient::recordConnect(uint8_t index, uint32_t elapsedMs) {
+  if (!lockStats(portMAX_DELAY)) return;
+  NtripEndpointStats& es = _stats.endpoints[index];
+  es.connects++;
+  es.lastConnectMs = elapsedMs;
+  es.avgConnectMs = es.avgConnectMs == 0
+      ? elapsedMs
+      : (uint32_t)((int32_t)es.avgConnectMs + ((int32_t)elapsedMs - (int32_t)es.avgConnectMs) / 8);
+  unlockStats();
+}
+
+void NtripClient::recordFailure(uint8_t index, NtripError err) {
+  if (!lockStats(portMAX_DELAY)) return;
+  _stats.endpoints[index].failures++;
+  _stats.endpoints[index].lastError = err;
+  unlockStats();
+}
+
+bool NtripClient::buildRequests(const NtripClientConfig& cfg) {
+  // Slot 0 is the primary; alternates follow in failover order. host/mount
+  // point into config, which is stable until the next begin().
+  endpointCount = 1 + cfg.alternateCount;
+  for (uint8_t i = 0; i < endpointCount; i++) {
+    EndpointSlot& ep = endpoints[i];
+    ep = EndpointSlot();
+    bool ok;
+    if (i == 0) {
+      ep.host = config.host.c_str();
+      ep.port = config.port;
+      ep.mount = config.mount.c_str();
+      ok = buildEndpointRequests(ep, config.user, config.pass, config.ggaSentence);
+    } else {
+      const NtripEndpoint& alt = config.alternates[i - 1];
+      ep.host = alt.host.c_str();
+      ep.port = alt.port;
+      ep.mount = alt.mount.c_str();
+      ok = buildEndpointRequests(ep, alt.user, alt.pass, config.ggaSentence);
+    }
+    if (!ok) return false;
+  }
+  return true;
+}
+
+bool NtripClient::buildEndpointRequests(EndpointSlot& ep, const String& user,
+                                        const String& pass, const String& gga) {
+  char credentials[NTRIP_CLIENT_AUTH_B64_LEN];
+  char auth[NTRIP_CLIENT_AUTH_B64_LEN];
+  int credLen = snprintf(credentials, sizeof(credentials), "%s:%s",
+                         user.c_str(), pass.c_str());
+  if (credLen < 0 || (size_t)credLen >= sizeof(credentials) ||
+      !encodeBase64(credentials, (size_t)credLen, auth, sizeof(auth))) {
+    return false;
+  }
+
+  // Rev2: HTTP/1.1 with Host, Ntrip-Version and optional Ntrip-GGA.
+  int n = snprintf(ep.requestRev2, sizeof(ep.requestRev2),
+                   "GET /%s HTTP/1.1\r\n"
+                   "User-Agent: NTRIP ESP32 v" NTRIP_CLIENT_VERSION "\r\n"
+                   "Host: %s\r\n"
+                   "Ntrip-Version: Ntrip/2.0\r\n"
+                   "Authorization: Basic %s\r\n"
+                   "%s%s%s"
+                   "\r\n",
+                   ep.mount, ep.host, auth,
+                   gga.length() > 0 ? "Ntrip-GGA: " : "",
+                   gga.c_str(),
+                   gga.length() > 0 ? "\r\n" : "");
+  if (n < 0 || (size_t)n >= sizeof(ep.requestRev2)) return false;
+  ep.requestRev2Len = (uint16_t)n;
+
+#if NTRIP_CLIENT_ENABLE_REV1_FALLBACK
+  // Rev1: HTTP/1.0, no Host / Ntrip-Version / GGA headers.
+  n = snprintf(ep.requestRev1, sizeof(ep.requestRev1),
+               "GET /%s HTTP/1.0\r\n"
+               "User-Agent: NTRIP ESP32 v" NTRIP_CLIENT_VERSION "\r\n"
+               "Authorization: Basic %s\r\n"
+               "\r\n",
+               ep.mount, auth);
+  if (n < 0 || (size_t)n >= sizeof(ep.requestRev1)) return false;
+  ep.requestRev1Len = (uint16_t)n;
+#endif
+
+  return true;
+}
+
+bool NtripClient::encodeBase64(const char* in, size_t len, char* out, size_t outLen) {
+  // Standard Base64 (RFC 4648) with padding into a fixed buffer.
+  static const char ALPHABET[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  if ((len + 2) / 3 * 4 + 1 > outLen) return false;
+
+  size_t o = 0;
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t v = (uint32_t)(uint8_t)in[i] << 16;
+    if (i + 1 < len) v |= (uint32_t)(uint8_t)in[i + 1] << 8;
+    if (i + 2 < len) v |= (uint8_t)in[i + 2];
+    out[o++] = ALPHABET[(v >> 18) & 0x3F];
+    out[o++] = ALPHABET[(v >> 12) & 0x3F];
+    out[o++] = i + 1 < len ? ALPHABET[(v >> 6) & 0x3F] : '=';
+    out[o++] = i + 2 < len ? ALPHABET[v & 0x3F] : '=';
+  }
+  out[o] = '\0';
+  return true;
 }
 
 // ─── State management ───────────────────────────────────────────────────────
@@ -470,19 +1958,44 @@ void NtripClient::disconnect() {
   if (client.connected()) client.stop();
   _healthy = false;
   _state = NtripState::DISCONNECTED;
-  if (statsMutex != nullptr && xSemaphoreTake(statsMutex, portMAX_DELAY)) {
+  if (lockStats(portMAX_DELAY)) {
     _stats.protocolVersion = 0;
-    xSemaphoreGive(statsMutex);
+    unlockStats();
   }
 }
 
-void NtripClient::setError(NtripError err, const String& msg) {
-  if (statsMutex != nullptr && xSemaphoreTake(statsMutex, portMAX_DELAY)) {
+void NtripClient::setError(NtripError err, const char* fmt, ...) {
+  // Format once into a fixed buffer; no String, no heap.
+  char msg[NTRIP_CLIENT_ERROR_MSG_LEN];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(msg, sizeof(msg), fmt, args);
+  va_end(args);
+
+  if (lockStats(portMAX_DELAY)) {
     _stats.lastError = err;
-    _stats.lastErrorMessage = msg;
-    xSemaphoreGive(statsMutex);
+    memcpy(_stats.lastErrorMessage, msg, sizeof(msg));
+    unlockStats();
   }
-  NTRIP_LOGE("%s", msg.c_str());
+  NTRIP_LOGE("%s", msg);
+}
+
+// ─── Stats seqlock ──────────────────────────────────────────────────────────
+
+bool NtripClient::lockStats(TickType_t timeout) {
+  // Writers serialize on the mutex, then mark the block as being modified.
+  if (statsMutex == nullptr || !xSemaphoreTake(statsMutex, timeout)) return false;
+  statsSeq.beginWrite();
+  return true;
+}
+
+void NtripClient::unlockStats() {
+  statsSeq.endWrite();
+  xSemaphoreGive(statsMutex);
+}
+
+void NtripClient::readStats(void* dst, const void* src, size_t len) const {
+  statsSeq.read([&] { memcpy(dst, src, len); });
 }
 
 bool NtripClient::isStreaming() const {
@@ -499,31 +2012,41 @@ NtripState NtripClient::state() const {
 
 NtripStats NtripClient::getStats() const {
   NtripStats snapshot;
-  if (statsMutex != nullptr && xSemaphoreTake(statsMutex, portMAX_DELAY)) {
-    snapshot = _stats;
-    xSemaphoreGive(statsMutex);
-  }
+  readStats(&snapshot, &_stats, sizeof(snapshot));
   return snapshot;
 }
 
 NtripError NtripClient::getLastError() const {
   NtripError err = NtripError::NONE;
-  if (statsMutex != nullptr && xSemaphoreTake(statsMutex, portMAX_DELAY)) {
-    err = _stats.lastError;
-    xSemaphoreGive(statsMutex);
-  }
+  readStats(&err, &_stats.lastError, sizeof(err));
   return err;
 }
 
 String NtripClient::getErrorMessage() const {
-  String msg;
-  if (statsMutex != nullptr && xSemaphoreTake(statsMutex, portMAX_DELAY)) {
-    msg = _stats.lastErrorMessage;
-    xSemaphoreGive(statsMutex);
-  }
-  return msg;
+  char msg[NTRIP_CLIENT_ERROR_MSG_LEN];
+  getErrorMessage(msg, sizeof(msg));
+  return String(msg);
 }
 
+size_t NtripClient::getErrorMessage(char* out, size_t len) const {
+  if (out == nullptr || len == 0) return 0;
+  char msg[NTRIP_CLIENT_ERROR_MSG_LEN];
+  readStats(msg, _stats.lastErrorMessage, sizeof(msg));
+  msg[sizeof(msg) - 1] = '\0';
+  const size_t n = min(strlen(msg), len - 1);
+  memcpy(out, msg, n);
+  out[n] = '\0';
+  return n;
+}
+
+#if NTRIP_CLIENT_ENABLE_LATENCY_STATS
+NtripLatencyStats NtripClient::getLatencyStats() const {
+  NtripLatencyStats snapshot;
+  readStats(&snapshot, &_latency, sizeof(snapshot));
+  return snapshot;
+}
+#endif
+
 void NtripClient::stop() {
   disconnect();
   failures = config.maxTries;
@@ -534,10 +2057,10 @@ void NtripClient::stop() {
 void NtripClient::reset() {
   failures = 0;
   _state = NtripState::DISCONNECTED;
-  if (statsMutex != nullptr && xSemaphoreTake(statsMutex, portMAX_DELAY)) {
+  if (lockStats(portMAX_DELAY)) {
     _stats.lastError = NtripError::NONE;
-    _stats.lastErrorMessage = "";
-    xSemaphoreGive(statsMutex);
+    _stats.lastErrorMessage[0] = '\0';
+    unlockStats();
   }
   NTRIP_LOGI("Reset — lockout cleared");
 }
@@ -552,12 +2075,147 @@ void NtripClient::setLogger(NtripLogFn logger) {
   logFn = logger;
 }
 
+void NtripClient::setPositionSource(NtripPositionFn fn, void* ctx) {
+  positionCtx = ctx;
+  positionFn = fn;
+}
+
+void NtripClient::updatePosition(const NtripPosition& pos) {
+  positionSlot.publish(pos);
+}
+
+bool NtripClient::readPosition(NtripPosition& pos, unsigned long& atMs) {
+  // Same source for the uplink and the time reference: the callback when
+  // set (its fix is taken as current at the call), else the slot.
+  if (positionFn != nullptr) {
+    atMs = millis();
+    return positionFn(pos, positionCtx);
+  }
+  return positionSlot.read(pos, &atMs);
+}
+
+void NtripClient::refreshTimeReference() {
+  // The rover's latest fix time (UTC) stamped when read is the GNSS clock.
+  NtripPosition pos;
+  unsigned long fixMs;
+  if (readPosition(pos, fixMs) && pos.valid) {
+    epochTracker.setTimeReference(pos.utcMsOfDay + NTRIP_CLIENT_GPS_LEAP_SECONDS * 1000UL, fixMs);
+  }
+}
+
+uint32_t NtripClient::healthLimitMs() const {
+  // The learned limit only ever tightens the fixed timeout.
+  const uint32_t adaptive = config.adaptiveHealth ? healthModel.limitMs() : 0;
+  return adaptive > 0 && adaptive < config.healthTimeoutMs ? adaptive : config.healthTimeoutMs;
+}
+
+// ─── Profile ────────────────────────────────────────────────────────────────
+
+void NtripClient::restoreProfile() {
+  NtripProfile stored;
+  if (!NtripProfileStore::load(config.profileNamespace.c_str(), stored)) return;
+  if (stored.configHash != NtripProfileStore::configHash(config) ||
+      stored.endpoint >= endpointCount) {
+    NTRIP_LOGI("Stored profile is for other caster settings — ignored");
+    return;
+  }
+  profile = stored;
+  profileValid = true;
+
+  activeEndpoint = profile.endpoint;
+  _stats.activeEndpoint = activeEndpoint;
+  CasterCache& cache = endpoints[activeEndpoint].cache;
+  if (profile.ip != 0) {
+    cache.ip = IPAddress(profile.ip);
+    cache.resolvedAt = millis();
+    cache.ipValid = true;
+  }
+  cache.version = profile.protocolVersion;
+  cache.fromProfile = true;
+  _stats.profileRestored = true;
+  NTRIP_LOGI("Profile restored (endpoint %u, Rev%u, station %u)",
+             profile.endpoint, profile.protocolVersion, profile.stationId);
+}
+
+void NtripClient::saveProfile(StreamContext& ctx, bool healthy) {
+  NtripProfile next;
+  const EndpointSlot& ep = endpoints[activeEndpoint];
+  next.configHash = NtripProfileStore::configHash(config);
+  next.ip = ep.cache.ipValid ? (uint32_t)ep.cache.ip : 0;
+  next.stationId = ctx.stationId;
+  next.endpoint = activeEndpoint;
+  next.protocolVersion = ep.cache.version;
+  next.healthy = healthy ? 1 : 0;
+  if (ctx.cache != nullptr) {
+    next.framesLen = (uint16_t)ctx.cache->exportStation(next.frames, sizeof(next.frames));
+  } else if (profileValid && profile.stationId == next.stationId) {
+    next.framesLen = profile.framesLen;
+    memcpy(next.frames, profile.frames, profile.framesLen);
+  }
+
+  // Unchanged profiles are not rewritten: NVS writes wear the flash.
+  if (profileValid && memcmp(&next, &profile, sizeof(next)) == 0) return;
+
+#if NTRIP_CLIENT_ENABLE_TASK && NTRIP_CLIENT_LOG_QUEUE_SIZE > 0
+  // The NVS commit takes tens of ms; the log task does it at its priority.
+  // profile tracks what was handed over, so a failed write is not retried
+  // until the profile changes again.
+  if (_logHandle != nullptr && xTaskGetCurrentTaskHandle() == _taskHandle) {
+    if (profilePending.load(std::memory_order_acquire)) {
+      NTRIP_LOGD("Profile write still pending — skipped");
+      return;
+    }
+    pendingProfile = next;
+    profilePending.store(true, std::memory_order_release);
+    xTaskNotifyGive(_logHandle);
+    profile = next;
+    profileValid = true;
+    return;
+  }
+#endif
+  if (!writeProfile(next)) return;
+  profile = next;
+  profileValid = true;
+}
+
+bool NtripClient::writeProfile(const NtripProfile& next) {
+  if (!NtripProfileStore::save(config.profileNamespace.c_str(), next)) {
+    NTRIP_LOGW("Profile write failed");
+    return false;
+  }
+  if (lockStats(portMAX_DELAY)) {
+    _stats.profileSaves++;
+    unlockStats();
+  }
+  NTRIP_LOGD("Profile saved (station %u, %u frame bytes)", next.stationId, next.framesLen);
+  return true;
+}
+
+bool NtripClient::clearProfile() {
+  profileValid = false;
+  return NtripProfileStore::erase(config.profileNamespace.c_str());
+}
+
+void NtripClient::setFrameInspector(NtripFrameFn fn, void* ctx) {
+  frameCtx = ctx;
+  frameFn = fn;
+}
+
 void NtripClient::logf(NtripLogLevel level, const char* fmt, ...) const {
-  if (logFn == nullptr || fmt == nullptr) return;
+  if (logFn == nullptr || fmt == nullptr || (int)level > NTRIP_CLIENT_LOG_LEVEL) return;
 
-  char message[256];
   va_list args;
   va_start(args, fmt);
+#if NTRIP_CLIENT_ENABLE_TASK && NTRIP_CLIENT_LOG_QUEUE_SIZE > 0
+  // The streaming task only queues; everyone else (begin, stopTask, the
+  // app) still logs synchronously.
+  if (_logHandle != nullptr && xTaskGetCurrentTaskHandle() == _taskHandle) {
+    if (logQueue.push((uint8_t)level, fmt, args)) xTaskNotifyGive(_logHandle);
+    va_end(args);
+    return;
+  }
+#endif
+  char message[256];
   vsnprintf(message, sizeof(message), fmt, args);
   va_end(args);
 
@@ -0,0 +1,178 @@
+#include "NtripLogQueue.h"
+
+// Record: length (2), level (1), pad (1), format pointer, then the
+// arguments in format order.
+static constexpr size_t HEADER_BYTES = 4 + sizeof(const char*);
+static constexpr size_t MAX_SPEC = 24;
+
+enum class ArgKind : uint8_t { NONE, INT, LONG, LLONG, SIZE, DOUBLE, PTR, STR, INVALID };
+
+// Parse the conversion after '%'; returns a pointer to its last character.
+static const char* parseSpec(const char* p, ArgKind& kind) {
+  kind = ArgKind::INVALID;
+  while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') p++;
+  while (*p >= '0' && *p <= '9') p++;
+  if (*p == '.') {
+    p++;
+    while (*p >= '0' && *p <= '9') p++;
+  }
+  if (*p == '*' || *p == '\0') return p;
+
+  ArgKind integer = ArgKind::INT;
+  if (p[0] == 'h') {
+    p += p[1] == 'h' ? 2 : 1;
+  } else if (p[0] == 'l' && p[1] == 'l') {
+    integer = ArgKind::LLONG;
+    p += 2;
+  } else if (p[0] == 'l') {
+    integer = ArgKind::LONG;
+    p++;
+  } else if (p[0] == 'z') {
+    integer = ArgKind::SIZE;
+    p++;
+  }
+
+  switch (*p) {
+    case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+      kind = integer;
+      break;
+    case 's': kind = integer == ArgKind::INT ? ArgKind::STR : ArgKind::INVALID; break;
+    case 'p': kind = ArgKind::PTR; break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': kind = ArgKind::DOUBLE; break;
+    case '%': kind = ArgKind::NONE; break;
+    default: break;
+  }
+  return *p != '\0' ? p : p - 1;
+}
+
+static bool put(uint8_t* rec, size_t& n, const void* value, size_t len) {
+  if (n + len > NtripLogQueue::MAX_RECORD) return false;
+  memcpy(rec + n, value, len);
+  n += len;
+  return true;
+}
+
+template <typename T>
+static T take(const uint8_t* rec, size_t& n) {
+  T value;
+  memcpy(&value, rec + n, sizeof(value));
+  n += sizeof(value);
+  return value;
+}
+
+bool NtripLogQueue::begin(uint8_t* storage, size_t capacity) {
+  droppedCount.store(0, std::memory_order_relaxed);
+  return ring.begin(storage, capacity);
+}
+
+bool NtripLogQueue::push(uint8_t level, const char* fmt, va_list args) {
+  uint8_t rec[MAX_RECORD];
+  size_t n = HEADER_BYTES;
+  bool ok = true;
+
+  for (const char* p = fmt; ok && *p != '\0'; p++) {
+    if (*p != '%') continue;
+    ArgKind kind;
+    const char* end = parseSpec(p + 1, kind);
+    // pop() copies '%' through end plus a terminator into spec[MAX_SPEC].
+    ok = (size_t)(end - p) < MAX_SPEC - 1;
+    switch (kind) {
+      case ArgKind::INT:    { int v = va_arg(args, int);             ok = ok && put(rec, n, &v, sizeof(v)); break; }
+      case ArgKind::LONG:   { long v = va_arg(args, long);           ok = ok && put(rec, n, &v, sizeof(v)); break; }
+      case ArgKind::LLONG:  { long long v = va_arg(args, long long); ok = ok && put(rec, n, &v, sizeof(v)); break; }
+      case ArgKind::SIZE:   { size_t v = va_arg(args, size_t);       ok = ok && put(rec, n, &v, sizeof(v)); break; }
+      case ArgKind::DOUBLE: { double v = va_arg(args, double);       ok = ok && put(rec, n, &v, sizeof(v)); break; }
+      case ArgKind::PTR:    { void* v = va_arg(args, void*);         ok = ok && put(rec, n, &v, sizeof(v)); break; }
+      case ArgKind::STR: {
+        const char* s = va_arg(args, const char*);
+        if (s == nullptr) s = "(null)";
+        const size_t len = strnlen(s, MAX_STRING);
+        const uint8_t len8 = (uint8_t)len;
+        ok = ok && put(rec, n, &len8, 1) && put(rec, n, s, len);
+        break;
+      }
+      case ArgKind::NONE: break;
+      case ArgKind::INVALID: ok = false; break;
+    }
+    p = end;
+  }
+
+  const uint16_t len = (uint16_t)n;
+  memcpy(rec, &len, sizeof(len));
+  rec[2] = level;
+  rec[3] = 0;
+  memcpy(rec + 4, &fmt, sizeof(fmt));
+  if (ok && ring.push(rec, n)) return true;
+  droppedCount.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void NtripLogQueue::read(uint8_t* out, size_t len) {
+  // push() is all-or-nothing, so a started record is complete; it may
+  // wrap, hence up to two pieces.
+  while (len > 0) {
+    const uint8_t* data = nullptr;
+    const size_t n = min(ring.peek(data), len);
+    memcpy(out, data, n);
+    ring.consume(n);
+    out += n;
+    len -= n;
+  }
+}
+
+bool NtripLogQueue::pop(uint8_t& level, char* out, size_t outLen) {
+  const uint8_t* head = nullptr;
+  if (outLen == 0 || ring.peek(head) == 0) return false;
+
+  uint8_t rec[MAX_RECORD];
+  uint16_t len;
+  read(rec, sizeof(len));
+  memcpy(&len, rec, sizeof(len));
+  read(rec + sizeof(len), len - sizeof(len));
+  level = rec[2];
+  const char* fmt;
+  memcpy(&fmt, rec + 4, sizeof(fmt));
+
+  // Replay the format one conversion at a time.
+  size_t in = HEADER_BYTES;
+  size_t o = 0;
+  for (const char* p = fmt; *p != '\0' && o + 1 < outLen; p++) {
+    if (*p != '%') {
+      out[o++] = *p;
+      continue;
+    }
+    ArgKind kind;
+    const char* end = parseSpec(p + 1, kind);
+    char spec[MAX_SPEC];
+    const size_t specLen = (size_t)(end - p) + 1;
+    memcpy(spec, p, specLen);
+    spec[specLen] = '\0';
+    p = end;
+
+    char* dst = out + o;
+    const size_t room = outLen - o;
+    int w = 0;
+    switch (kind) {
+      case ArgKind::INT:    w = snprintf(dst, room, spec, take<int>(rec, in)); break;
+      case ArgKind::LONG:   w = snprintf(dst, room, spec, take<long>(rec, in)); break;
+      case ArgKind::LLONG:  w = snprintf(dst, room, spec, take<long long>(rec, in)); break;
+      case ArgKind::SIZE:   w = snprintf(dst, room, spec, take<size_t>(rec, in)); break;
+      case ArgKind::DOUBLE: w = snprintf(dst, room, spec, take<double>(rec, in)); break;
+      case ArgKind::PTR:    w = snprintf(dst, room, spec, take<void*>(rec, in)); break;
+      case ArgKind::STR: {
+        char s[MAX_STRING + 1];
+        const uint8_t sl = rec[in++];
+        memcpy(s, rec + in, sl);
+        s[sl] = '\0';
+        in += sl;
+        w = snprintf(dst, room, spec, s);
+        break;
+      }
+      case ArgKind::NONE: *dst = '%'; w = 1; break;
+      case ArgKind::INVALID: break;  // Never queued
+    }
+    if (w > 0) o += min((size_t)w, room - 1);
+  }
+  out[o] = '\0';
+  return true;
+}
@@ -0,0 +1,62 @@
+#include "NtripProfile.h"
+#include "NtripClient.h"
+#include <Preferences.h>
+
+static const char* PROFILE_KEY = "profile";
+
+bool NtripProfileStore::load(const char* name, NtripProfile& out) {
+  Preferences prefs;
+  if (!prefs.begin(name, true)) return false;
+  NtripProfile p;
+  const bool ok = prefs.getBytesLength(PROFILE_KEY) == sizeof(p) &&
+                  prefs.getBytes(PROFILE_KEY, &p, sizeof(p)) == sizeof(p);
+  prefs.end();
+  if (!ok || p.magic != NtripProfile::MAGIC || p.framesLen > sizeof(p.frames)) return false;
+  out = p;
+  return true;
+}
+
+bool NtripProfileStore::save(const char* name, const NtripProfile& profile) {
+  Preferences prefs;
+  if (!prefs.begin(name, false)) return false;
+  const bool ok = prefs.putBytes(PROFILE_KEY, &profile, sizeof(profile)) == sizeof(profile);
+  prefs.end();
+  return ok;
+}
+
+bool NtripProfileStore::erase(const char* name) {
+  Preferences prefs;
+  if (!prefs.begin(name, false)) return false;
+  const bool ok = prefs.remove(PROFILE_KEY);
+  prefs.end();
+  return ok;
+}
+
+static uint32_t fnv1a(uint32_t h, const void* data, size_t len) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < len; i++) {
+    h ^= p[i];
+    h *= 16777619UL;
+  }
+  return h;
+}
+
+static uint32_t hashEndpoint(uint32_t h, const String& host, uint16_t port,
+                             const String& mount, const String& user) {
+  // Lengths are hashed too so ("ab","c") and ("a","bc") differ.
+  const size_t lens[3] = {host.length(), mount.length(), user.length()};
+  h = fnv1a(h, lens, sizeof(lens));
+  h = fnv1a(h, host.c_str(), host.length());
+  h = fnv1a(h, &port, sizeof(port));
+  h = fnv1a(h, mount.c_str(), mount.length());
+  return fnv1a(h, user.c_str(), user.length());
+}
+
+uint32_t NtripProfileStore::configHash(const NtripClientConfig& cfg) {
+  uint32_t h = hashEndpoint(2166136261UL, cfg.host, cfg.port, cfg.mount, cfg.user);
+  for (uint8_t i = 0; i < cfg.alternateCount; i++) {
+    const NtripEndpoint& alt = cfg.alternates[i];
+    h = hashEndpoint(h, alt.host, alt.port, alt.mount, alt.user);
+  }
+  return h;
+}
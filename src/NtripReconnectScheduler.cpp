@@ -0,0 +1,55 @@
+#include "NtripReconnectScheduler.h"
+#include "NtripClient.h"
+
+void NtripReconnectScheduler::configure(const NtripClientConfig& cfg) {
+  policy = cfg.retryPolicy;
+  fastFirstRetry = cfg.fastFirstRetry;
+  fixedDelayMs = cfg.retryDelayMs;
+  baseDelayMs = cfg.retryBaseDelayMs;
+  maxDelayMs = cfg.retryMaxDelayMs;
+  probeIntervalMs = cfg.probeIntervalMs;
+  maxTries = cfg.maxTries;
+  from = 0;
+  wait = 0;
+  probe = false;
+}
+
+uint32_t NtripReconnectScheduler::uniform(uint32_t lo, uint32_t hi) {
+  // Arduino random() draws from the hardware RNG on ESP32, so devices that
+  // booted together still diverge.
+  if (hi <= lo) return lo;
+  const uint32_t span = min<uint32_t>(hi - lo, 0x7FFFFFFE);
+  return lo + (uint32_t)random((long)span + 1);
+}
+
+bool NtripReconnectScheduler::schedule(uint8_t failures, unsigned long nowMs,
+                                       unsigned long lastAttemptMs) {
+  probe = false;
+  from = nowMs;
+
+  if (failures >= maxTries) {
+    if (probeIntervalMs == 0) return false;
+    probe = true;
+    wait = uniform(probeIntervalMs / 2, probeIntervalMs);
+    return true;
+  }
+
+  if (failures == 0 && fastFirstRetry) {
+    wait = 0;
+    return true;
+  }
+
+  if (policy == NtripRetryPolicy::FIXED) {
+    from = lastAttemptMs;
+    wait = fixedDelayMs;
+    return true;
+  }
+
+  // Window doubles per failure: base, base, 2·base, 4·base … up to the cap.
+  uint32_t window = baseDelayMs;
+  for (uint8_t i = 1; i < failures && window < maxDelayMs; i++) {
+    window = window > maxDelayMs / 2 ? maxDelayMs : window * 2;
+  }
+  wait = uniform(0, min(window, maxDelayMs));
+  return true;
+}
@@ -0,0 +1,119 @@
+#include "NtripResponseParser.h"
+
+// Case-insensitive "Name:" match; returns the trimmed value or nullptr.
+static const char* headerValue(const char* line, const char* name) {
+  const size_t n = strlen(name);
+  if (strncasecmp(line, name, n) != 0 || line[n] != ':') return nullptr;
+  const char* value = line + n + 1;
+  while (*value == ' ' || *value == '\t') value++;
+  return value;
+}
+
+void NtripResponseParser::reset() {
+  state = STATUS;
+  _status = NtripResponseStatus::PENDING;
+  _statusCode = 0;
+  chunked = false;
+  lineLen = 0;
+  line[0] = '\0';
+  statusBuf[0] = '\0';
+  contentTypeBuf[0] = '\0';
+}
+
+size_t NtripResponseParser::feed(const uint8_t* data, size_t len) {
+  size_t i = 0;
+  while (i < len && state != DONE) {
+    const uint8_t b = data[i];
+
+    switch (state) {
+      case STATUS:
+        // Status line, terminated by '\n' ('\r' dropped).
+        if (b == '\n') {
+          finishStatusLine();
+        } else {
+          appendLine(b);
+        }
+        break;
+
+      case HEADER_START:
+        // Blank line ends the headers. Rev1 casters may start RTCM right
+        // after "ICY 200 OK" — a non-text byte here means the body began.
+        if (b == '\n') {
+          state = DONE;
+        } else if (b == '\r') {
+          // Part of the blank line (or a CRLF header) — wait for '\n'.
+        } else if (_status == NtripResponseStatus::ICY_OK && (b >= 0x80 || b < 0x20)) {
+          state = DONE;
+          return i;
+        } else {
+          appendLine(b);
+          state = HEADER;
+        }
+        break;
+
+      case HEADER:
+        if (b == '\n') {
+          finishHeaderLine();
+          state = HEADER_START;
+        } else {
+          appendLine(b);
+        }
+        break;
+
+      case DONE:
+        break;
+    }
+    i++;
+  }
+  return i;
+}
+
+void NtripResponseParser::appendLine(uint8_t b) {
+  // Drop CR and truncate overlong lines.
+  if (b == '\r') return;
+  if (lineLen + 1 < sizeof(line)) line[lineLen++] = (char)b;
+}
+
+void NtripResponseParser::finishStatusLine() {
+  line[lineLen] = '\0';
+  memcpy(statusBuf, line, lineLen + 1);
+  lineLen = 0;
+
+  // "<protocol> <code> <reason>"
+  const char* space = strchr(statusBuf, ' ');
+  _statusCode = space != nullptr ? (uint16_t)atoi(space + 1) : 0;
+
+  if (strncmp(statusBuf, "ICY ", 4) == 0 && _statusCode == 200) {
+    _status = NtripResponseStatus::ICY_OK;
+  } else if (strncmp(statusBuf, "HTTP/", 5) == 0 && _statusCode == 200) {
+    _status = NtripResponseStatus::HTTP_OK;
+  } else if (strncmp(statusBuf, "SOURCETABLE ", 12) == 0) {
+    // Casters answer an unknown mountpoint with their source table.
+    _status = NtripResponseStatus::NOT_FOUND;
+  } else if (_statusCode == 401) {
+    _status = NtripResponseStatus::UNAUTHORIZED;
+  } else if (_statusCode == 404) {
+    _status = NtripResponseStatus::NOT_FOUND;
+  } else {
+    _status = NtripResponseStatus::ERROR;
+  }
+
+  // Headers of an error response are irrelevant.
+  state = isOk() ? HEADER_START : DONE;
+}
+
+void NtripResponseParser::finishHeaderLine() {
+  line[lineLen] = '\0';
+  lineLen = 0;
+
+  const char* value = headerValue(line, "Transfer-Encoding");
+  if (value != nullptr) {
+    chunked = strstr(value, "chunked") != nullptr;
+    return;
+  }
+  value = headerValue(line, "Content-Type");
+  if (value != nullptr) {
+    strncpy(contentTypeBuf, value, sizeof(contentTypeBuf) - 1);
+    contentTypeBuf[sizeof(contentTypeBuf) - 1] = '\0';
+  }
+}
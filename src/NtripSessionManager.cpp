@@ -0,0 +1,650 @@
+#include "NtripSessionManager.h"
+
+#if NTRIP_CLIENT_ENABLE_TASK
+
+#include "RtcmParser.h"
+#include <stdarg.h>
+#include <errno.h>
+#include <lwip/sockets.h>
+
+// Local counters are flushed to published stats at this cadence.
+static constexpr unsigned long SESSION_FLUSH_MS = 250;
+// Upper bound on one select() wait; timeouts are checked on every wake.
+static constexpr uint32_t SELECT_SLICE_MS = 20;
+
+// WAIT:     scheduled retry (or lockout check) before the next attempt.
+// CONNECT:  non-blocking TCP connect in progress.
+// REQUEST:  sending the pre-serialized request.
+// RESPONSE: reading the response head.
+// STREAM:   forwarding and validating RTCM.
+// LOCKED:   maxTries exhausted and no probing; idle until reset().
+enum class SessionPhase : uint8_t { WAIT, CONNECT, REQUEST, RESPONSE, STREAM, LOCKED };
+
+// One mountpoint. Everything except the published fields is owned by the
+// shard task that serves it.
+struct NtripSessionManager::Session {
+  NtripSessionManager* self = nullptr;
+  uint8_t index = 0;
+  NtripClientConfig cfg;
+  Print* sink = nullptr;
+  NtripClient::EndpointSlot ep;
+
+  int fd = -1;
+  SessionPhase phase = SessionPhase::WAIT;
+  bool useRev2 = true;
+  bool retryNow = false;   // Rev2 refused: try Rev1 without waiting
+  size_t sent = 0;
+  uint8_t failures = 0;
+  unsigned long lastAttempt = 0;
+  NtripReconnectScheduler retry;
+  bool retryScheduled = false;  // retry holds the plan for this WAIT spell
+  unsigned long phaseStart = 0;
+  unsigned long lastHealth = 0;
+  unsigned long lastSample = 0;
+  unsigned long lastFlush = 0;
+
+  NtripResponseParser response;
+  HttpChunkDecoder chunks;
+  bool chunked = false;
+  RtcmParser parser;
+  uint8_t validFrames = 0;
+  bool validated = false;
+  uint8_t* buffer = nullptr;
+
+  // Local accumulators, flushed every SESSION_FLUSH_MS.
+  uint32_t localBytes = 0;
+  uint32_t localFrames = 0;
+  uint32_t localCrcErrors = 0;
+  uint16_t localLastMsgType = 0;
+  unsigned long localLastFrameTime = 0;
+
+  // Published — readable from any task.
+  volatile NtripState state = NtripState::DISCONNECTED;
+  volatile bool healthy = false;
+  std::atomic<bool> reconnectRequested{false};
+  std::atomic<bool> resetRequested{false};
+  NtripStats stats;
+  NtripSeqlock statsSeq;  // Single writer (the shard task), so no mutex
+};
+
+// ─── Lifecycle ──────────────────────────────────────────────────────────────
+
+NtripSessionManager::~NtripSessionManager() {
+  stop();
+  for (uint8_t i = 0; i < count; i++) delete sessions[i];
+}
+
+int NtripSessionManager::addSession(const NtripClientConfig& cfg, Print& sink) {
+  if (_running || count >= NTRIP_SESSION_MAX_SESSIONS) return -1;
+
+  String validationError;
+  if (!NtripClient::validateConfig(cfg, validationError)) {
+    if (logFn != nullptr) logFn(NtripLogLevel::Error, "NtripSession", validationError.c_str());
+    return -1;
+  }
+  if (cfg.frameAlignedOutput || cfg.outputRingSize > 0 || cfg.alternateCount > 0 ||
+      cfg.raceProtocols || cfg.frameCacheSize > 0 || cfg.persistProfile || cfg.sinkCount > 0) {
+    if (logFn != nullptr) {
+      logFn(NtripLogLevel::Error, "NtripSession",
+            "frameAlignedOutput/outputRingSize/alternates/raceProtocols/frameCacheSize/persistProfile/sinks are NtripClient-only");
+    }
+    return -1;
+  }
+
+  Session* s = new Session();
+  if (s == nullptr) return -1;
+  s->self = this;
+  s->index = count;
+  s->cfg = cfg;
+  s->sink = &sink;
+
+  // host/mount point into the session's own config copy.
+  s->ep.host = s->cfg.host.c_str();
+  s->ep.port = s->cfg.port;
+  s->ep.mount = s->cfg.mount.c_str();
+  if (!NtripClient::buildEndpointRequests(s->ep, s->cfg.user, s->cfg.pass, s->cfg.ggaSentence)) {
+    delete s;
+    if (logFn != nullptr) {
+      logFn(NtripLogLevel::Error, "NtripSession", "request exceeds NTRIP_CLIENT_REQUEST_LEN");
+    }
+    return -1;
+  }
+  s->stats.endpointCount = 1;
+
+  sessions[count] = s;
+  return count++;
+}
+
+bool NtripSessionManager::start(uint8_t core, bool shardAcrossCores) {
+  if (_running || count == 0) return false;
+
+  for (uint8_t i = 0; i < count; i++) {
+    Session& s = *sessions[i];
+    if (s.buffer == nullptr) s.buffer = new uint8_t[s.cfg.bufferSize];
+    if (s.buffer == nullptr) {
+      logf(s, NtripLogLevel::Error, "Buffer allocation failed");
+      return false;
+    }
+    s.phase = SessionPhase::WAIT;
+    s.failures = 0;
+    s.lastAttempt = 0;
+    s.retry.configure(s.cfg);
+    s.retryScheduled = false;
+  }
+
+  shardCount = shardAcrossCores && count > 1 ? 2 : 1;
+  _running = true;
+  for (uint8_t k = 0; k < shardCount; k++) {
+    Shard& shard = shards[k];
+    shard.self = this;
+    shard.first = k;
+    shard.stride = shardCount;
+    const uint8_t shardCore = shardCount == 2 ? k : core;
+    BaseType_t result = xTaskCreatePinnedToCore(
+        shardEntry, "NtripSessions", NTRIP_SESSION_TASK_STACK, &shard, 1,
+        &shard.handle, shardCore);
+    if (result != pdPASS) {
+      shard.handle = nullptr;
+      if (logFn != nullptr) logFn(NtripLogLevel::Error, "NtripSession", "Failed to create task");
+      stop();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool NtripSessionManager::stop() {
+  bool wasRunning = false;
+  for (uint8_t k = 0; k < shardCount; k++) wasRunning |= shards[k].handle != nullptr;
+  if (!wasRunning && !_running) return false;
+
+  _running = false;
+
+  // Wait for shard tasks to self-terminate.
+  unsigned long start = millis();
+  for (;;) {
+    bool alive = false;
+    for (uint8_t k = 0; k < shardCount; k++) alive |= shards[k].handle != nullptr;
+    if (!alive || millis() - start >= 5000) break;
+    vTaskDelay(pdMS_TO_TICKS(100));
+  }
+
+  // Force-delete if still alive after timeout.
+  for (uint8_t k = 0; k < shardCount; k++) {
+    if (shards[k].handle != nullptr) {
+      vTaskDelete(shards[k].handle);
+      shards[k].handle = nullptr;
+    }
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    Session& s = *sessions[i];
+    if (s.fd >= 0) {
+      close(s.fd);
+      s.fd = -1;
+    }
+    s.phase = SessionPhase::WAIT;
+    s.state = NtripState::DISCONNECTED;
+    s.healthy = false;
+    delete[] s.buffer;
+    s.buffer = nullptr;
+  }
+  return true;
+}
+
+bool NtripSessionManager::isRunning() const {
+  return _running;
+}
+
+// ─── Shard task ─────────────────────────────────────────────────────────────
+
+void NtripSessionManager::shardEntry(void* arg) {
+  Shard& shard = *static_cast<Shard*>(arg);
+  shard.self->shardLoop(shard);
+  shard.handle = nullptr;
+  vTaskDelete(nullptr);
+}
+
+void NtripSessionManager::shardLoop(Shard& shard) {
+  while (_running) {
+    fd_set readSet;
+    fd_set writeSet;
+    FD_ZERO(&readSet);
+    FD_ZERO(&writeSet);
+    int maxFd = -1;
+
+    // Apply control requests and idle transitions, then collect sockets.
+    for (uint8_t i = shard.first; i < count; i += shard.stride) {
+      Session& s = *sessions[i];
+      if (s.resetRequested.exchange(false)) {
+        s.failures = 0;
+        s.retryScheduled = false;
+        if (s.phase == SessionPhase::LOCKED) {
+          s.phase = SessionPhase::WAIT;
+          s.state = NtripState::DISCONNECTED;
+        }
+      }
+      if (s.reconnectRequested.exchange(false) && s.phase != SessionPhase::LOCKED) {
+        closeSession(s, NtripError::NONE, "Reconnection requested");
+        s.lastAttempt = 0;
+      }
+      if (s.phase == SessionPhase::WAIT) service(s, false, false);
+
+      if (s.fd < 0) continue;
+      if (s.phase == SessionPhase::CONNECT || s.phase == SessionPhase::REQUEST) {
+        FD_SET(s.fd, &writeSet);
+      } else {
+        FD_SET(s.fd, &readSet);
+      }
+      if (s.fd > maxFd) maxFd = s.fd;
+    }
+
+    if (maxFd < 0) {
+      vTaskDelay(pdMS_TO_TICKS(SELECT_SLICE_MS));
+    } else {
+      struct timeval tv;
+      tv.tv_sec = 0;
+      tv.tv_usec = SELECT_SLICE_MS * 1000;
+      if (select(maxFd + 1, &readSet, &writeSet, nullptr, &tv) < 0) {
+        FD_ZERO(&readSet);
+        FD_ZERO(&writeSet);
+        vTaskDelay(pdMS_TO_TICKS(10));
+      }
+    }
+
+    // Service every session: I/O readiness plus timeouts and health.
+    for (uint8_t i = shard.first; i < count; i += shard.stride) {
+      Session& s = *sessions[i];
+      if (s.phase != SessionPhase::WAIT && s.phase != SessionPhase::LOCKED) {
+        const bool readable = s.fd >= 0 && FD_ISSET(s.fd, &readSet);
+        const bool writable = s.fd >= 0 && FD_ISSET(s.fd, &writeSet);
+        service(s, readable, writable);
+      }
+      if (millis() - s.lastFlush >= SESSION_FLUSH_MS) flushStats(s);
+    }
+  }
+
+  for (uint8_t i = shard.first; i < count; i += shard.stride) flushStats(*sessions[i]);
+}
+
+void NtripSessionManager::service(Session& s, bool readable, bool writable) {
+  switch (s.phase) {
+    case SessionPhase::WAIT:
+      if (!s.retryScheduled) {
+        if (!s.retry.schedule(s.failures, millis(), s.lastAttempt)) {
+          closeSession(s, NtripError::MAX_RETRIES_EXCEEDED, "Failed %u times", s.failures);
+          s.phase = SessionPhase::LOCKED;
+          s.state = NtripState::LOCKED_OUT;
+          return;
+        }
+        s.retryScheduled = true;
+        s.statsSeq.beginWrite();
+        s.stats.retryWaitMs = s.retry.waitMs();
+        s.statsSeq.endWrite();
+      }
+      if (!s.retryNow && s.lastAttempt != 0 && !s.retry.due(millis())) return;
+      if (s.retry.probing()) {
+        s.statsSeq.beginWrite();
+        s.stats.probes++;
+        s.statsSeq.endWrite();
+      }
+      s.retryScheduled = false;
+      beginConnect(s);
+      return;
+
+    case SessionPhase::CONNECT:
+      if (writable) finishConnect(s);
+      break;
+
+    case SessionPhase::REQUEST:
+      if (writable) {
+        const char* request = s.ep.requestRev2;
+        size_t requestLen = s.ep.requestRev2Len;
+#if NTRIP_CLIENT_ENABLE_REV1_FALLBACK
+        if (!s.useRev2) {
+          request = s.ep.requestRev1;
+          requestLen = s.ep.requestRev1Len;
+        }
+#endif
+        const int n = send(s.fd, request + s.sent, requestLen - s.sent, 0);
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+          closeSession(s, NtripError::TCP_CONNECT_FAILED, "Request send to %s failed", s.ep.host);
+          return;
+        }
+        if (n > 0) s.sent += n;
+        if (s.sent == requestLen) {
+          s.response.reset();
+          s.phase = SessionPhase::RESPONSE;
+        }
+      }
+      break;
+
+    case SessionPhase::RESPONSE:
+      if (readable) handleResponse(s);
+      break;
+
+    case SessionPhase::STREAM:
+      if (readable) handleStream(s);
+      if (s.phase == SessionPhase::STREAM &&
+          millis() - s.lastHealth > s.cfg.healthTimeoutMs) {
+        closeSession(s, NtripError::ZOMBIE_STREAM_DETECTED, "No valid RTCM for %lus",
+                     (unsigned long)(s.cfg.healthTimeoutMs / 1000));
+      }
+      return;
+
+    case SessionPhase::LOCKED:
+      return;
+  }
+
+  // Handshake phases share one deadline.
+  if (s.phase != SessionPhase::WAIT && s.phase != SessionPhase::STREAM &&
+      millis() - s.phaseStart >= s.cfg.connectTimeoutMs) {
+    if (s.phase == SessionPhase::RESPONSE) {
+      closeSession(s, NtripError::HTTP_TIMEOUT, "No response from %s", s.ep.host);
+    } else {
+      closeSession(s, NtripError::TCP_CONNECT_FAILED, "Cannot reach %s:%u", s.ep.host, s.ep.port);
+    }
+  }
+}
+
+// ─── Handshake ──────────────────────────────────────────────────────────────
+
+void NtripSessionManager::beginConnect(Session& s) {
+  if (!s.retryNow && s.cfg.rememberProtocol && s.ep.cache.version != 0) {
+    s.useRev2 = s.ep.cache.version == 2;
+  }
+  s.lastAttempt = millis();
+  s.phaseStart = millis();
+  s.retryNow = false;
+  s.state = NtripState::CONNECTING;
+  logf(s, NtripLogLevel::Info, "Connecting to %s:%d/%s (Rev%d, attempt %d/%d)",
+       s.ep.host, s.ep.port, s.ep.mount, s.useRev2 ? 2 : 1, s.failures + 1, s.cfg.maxTries);
+
+  // DNS is the one blocking step (cached with dnsCacheTtlMs > 0).
+  IPAddress ip;
+  if (!NtripClient::resolveCaster(s.cfg, s.ep, ip)) {
+    s.phase = SessionPhase::CONNECT;
+    closeSession(s, NtripError::TCP_CONNECT_FAILED, "Cannot resolve %s", s.ep.host);
+    return;
+  }
+
+  s.fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (s.fd < 0) {
+    s.phase = SessionPhase::CONNECT;
+    closeSession(s, NtripError::TCP_CONNECT_FAILED, "No socket for %s", s.ep.host);
+    return;
+  }
+  fcntl(s.fd, F_SETFL, fcntl(s.fd, F_GETFL, 0) | O_NONBLOCK);
+  int one = 1;
+  setsockopt(s.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(s.ep.port);
+  addr.sin_addr.s_addr = (uint32_t)ip;
+
+  s.phase = SessionPhase::CONNECT;
+  if (connect(s.fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 && errno != EINPROGRESS) {
+    s.ep.cache.ipValid = false;
+    closeSession(s, NtripError::TCP_CONNECT_FAILED, "Cannot reach %s:%u", s.ep.host, s.ep.port);
+  }
+}
+
+void NtripSessionManager::finishConnect(Session& s) {
+  int err = 0;
+  socklen_t len = sizeof(err);
+  if (getsockopt(s.fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err != 0) {
+    s.ep.cache.ipValid = false;
+    closeSession(s, NtripError::TCP_CONNECT_FAILED, "Cannot reach %s:%u", s.ep.host, s.ep.port);
+    return;
+  }
+  s.sent = 0;
+  s.phase = SessionPhase::REQUEST;
+}
+
+void NtripSessionManager::handleResponse(Session& s) {
+  const int n = recv(s.fd, s.buffer, s.cfg.bufferSize, 0);
+  if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+    closeSession(s, NtripError::HTTP_TIMEOUT, "No response from %s", s.ep.host);
+    return;
+  }
+  if (n < 0) return;
+
+  const size_t consumed = s.response.feed(s.buffer, n);
+  if (!s.response.done()) return;
+
+  if (!s.response.isOk()) {
+    logf(s, NtripLogLevel::Info, "Response: %s", s.response.statusLine());
+#if NTRIP_CLIENT_ENABLE_REV1_FALLBACK
+    if (s.useRev2) {
+      // Same attempt, older protocol — not counted as a failure yet.
+      logf(s, NtripLogLevel::Warning, "Rev2 failed, falling back to Rev1");
+      close(s.fd);
+      s.fd = -1;
+      s.useRev2 = false;
+      s.retryNow = true;
+      s.phase = SessionPhase::WAIT;
+      return;
+    }
+#endif
+    switch (s.response.status()) {
+      case NtripResponseStatus::UNAUTHORIZED:
+        closeSession(s, NtripError::HTTP_AUTH_FAILED, "Invalid credentials for %s", s.ep.host);
+        break;
+      case NtripResponseStatus::NOT_FOUND:
+        closeSession(s, NtripError::HTTP_MOUNT_NOT_FOUND, "Mount not found: %s", s.ep.mount);
+        break;
+      default:
+        closeSession(s, NtripError::HTTP_UNKNOWN_ERROR, "HTTP error: %s", s.response.statusLine());
+        break;
+    }
+    return;
+  }
+
+  logf(s, NtripLogLevel::Info, "Connected (%s) — validating stream", s.response.statusLine());
+  s.ep.cache.version = s.useRev2 ? 2 : 1;
+  s.phase = SessionPhase::STREAM;
+  s.state = NtripState::STREAMING;
+  s.healthy = false;
+  s.parser.reset();
+  s.chunked = s.response.isChunked();
+  s.chunks.reset();
+  s.validFrames = 0;
+  s.validated = false;
+  s.lastHealth = millis();
+
+  s.statsSeq.beginWrite();
+  s.stats.reconnects++;
+  s.stats.connectionStart = millis();
+  s.stats.protocolVersion = s.ep.cache.version;
+  s.stats.lastError = NtripError::NONE;
+  s.stats.lastErrorMessage[0] = '\0';
+  s.statsSeq.endWrite();
+
+  // Body bytes that arrived with the headers
+  const size_t leftover = n - consumed;
+  if (leftover > 0) {
+    memmove(s.buffer, s.buffer + consumed, leftover);
+    size_t len = leftover;
+    if (s.chunked) len = s.chunks.decode(s.buffer, len);
+    if (len > 0) {
+      s.localBytes += len;
+      s.sink->write(s.buffer, len);
+      s.parser.feed(s.buffer, len, onFrame, &s);
+    }
+  }
+}
+
+// ─── Streaming ──────────────────────────────────────────────────────────────
+
+void NtripSessionManager::handleStream(Session& s) {
+  const int n = recv(s.fd, s.buffer, s.cfg.bufferSize, 0);
+  if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+    closeSession(s, NtripError::TCP_CONNECT_FAILED, "Socket closed by %s", s.ep.host);
+    return;
+  }
+  if (n < 0) return;
+
+  size_t len = n;
+  if (s.chunked) {
+    // Rev2 chunked body: strip chunk framing in place before parse/forward
+    len = s.chunks.decode(s.buffer, len);
+    if (s.chunks.failed()) {
+      closeSession(s, NtripError::STREAM_VALIDATION_FAILED,
+                   "Malformed chunked encoding from %s", s.ep.host);
+      return;
+    }
+  }
+  if (len == 0) return;
+
+  s.localBytes += len;
+  s.sink->write(s.buffer, len);
+
+  if (!s.validated || s.cfg.continuousValidation) {
+    s.parser.feed(s.buffer, len, onFrame, &s);
+  } else if (millis() - s.lastSample > s.cfg.passiveSampleMs) {
+    // Passive sampling — scan for RTCM preamble periodically
+    const size_t scanLimit = min(len, (size_t)NTRIP_CLIENT_PASSIVE_SCAN_BYTES);
+    if (memchr(s.buffer, 0xD3, scanLimit) != nullptr) {
+      s.lastHealth = millis();
+      s.lastSample = millis();
+      s.localLastFrameTime = millis();
+      s.healthy = true;
+    } else {
+      logf(s, NtripLogLevel::Warning, "No preamble in sample");
+    }
+  }
+}
+
+bool NtripSessionManager::onFrame(const RtcmResult& frame, size_t, void* arg) {
+  Session& s = *static_cast<Session*>(arg);
+  if (frame.crcError) {
+    s.localCrcErrors++;
+    return true;
+  }
+
+  const unsigned long now = millis();
+  s.lastHealth = now;
+  s.localFrames++;
+  s.localLastMsgType = frame.messageType;
+  s.localLastFrameTime = now;
+  if (s.validated) return true;
+
+  if (++s.validFrames >= s.cfg.requiredValidFrames) {
+    // Only a validated stream clears the failure count: a caster that
+    // answers 200 and then drops or sends garbage keeps backing off.
+    s.validated = true;
+    s.failures = 0;
+    s.healthy = true;
+    s.lastSample = now;
+    s.self->logf(s, NtripLogLevel::Info, "Stream validated");
+    // Passive mode: stop parsing the rest of this read.
+    return s.cfg.continuousValidation;
+  }
+  return true;
+}
+
+// ─── State management ───────────────────────────────────────────────────────
+
+void NtripSessionManager::closeSession(Session& s, NtripError err, const char* fmt, ...) {
+  const bool handshake = s.phase == SessionPhase::CONNECT ||
+                         s.phase == SessionPhase::REQUEST ||
+                         s.phase == SessionPhase::RESPONSE;
+  const bool unvalidated = s.phase == SessionPhase::STREAM && !s.validated &&
+                           err != NtripError::NONE;
+  if (s.fd >= 0) {
+    close(s.fd);
+    s.fd = -1;
+  }
+  s.healthy = false;
+  s.state = NtripState::DISCONNECTED;
+  s.phase = SessionPhase::WAIT;
+  if (handshake) {
+    if (s.failures < 0xFF) s.failures++;
+    s.useRev2 = true;
+    s.ep.cache.version = 0;
+  } else if (unvalidated && s.failures < 0xFF) {
+    s.failures++;
+  }
+
+  char msg[NTRIP_CLIENT_ERROR_MSG_LEN];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(msg, sizeof(msg), fmt, args);
+  va_end(args);
+
+  s.statsSeq.beginWrite();
+  s.stats.protocolVersion = 0;
+  if (err != NtripError::NONE) {
+    s.stats.lastError = err;
+    memcpy(s.stats.lastErrorMessage, msg, sizeof(msg));
+  }
+  s.statsSeq.endWrite();
+
+  logf(s, err == NtripError::NONE ? NtripLogLevel::Info : NtripLogLevel::Error, "%s", msg);
+}
+
+void NtripSessionManager::flushStats(Session& s) {
+  s.statsSeq.beginWrite();
+  s.stats.bytesReceived += s.localBytes;
+  s.stats.totalFrames += s.localFrames;
+  s.stats.crcErrors += s.localCrcErrors;
+  if (s.localLastMsgType != 0)   s.stats.lastMessageType = s.localLastMsgType;
+  if (s.localLastFrameTime != 0) s.stats.lastFrameTime = s.localLastFrameTime;
+  if (s.phase == SessionPhase::STREAM && s.stats.connectionStart > 0) {
+    s.stats.totalUptime = millis() - s.stats.connectionStart;
+  }
+  s.statsSeq.endWrite();
+
+  s.localBytes = 0;
+  s.localFrames = 0;
+  s.localCrcErrors = 0;
+  s.localLastMsgType = 0;
+  s.localLastFrameTime = 0;
+  s.lastFlush = millis();
+}
+
+NtripState NtripSessionManager::state(uint8_t index) const {
+  return index < count ? sessions[index]->state : NtripState::DISCONNECTED;
+}
+
+bool NtripSessionManager::isHealthy(uint8_t index) const {
+  return index < count && sessions[index]->healthy;
+}
+
+NtripStats NtripSessionManager::getStats(uint8_t index) const {
+  NtripStats snapshot;
+  if (index >= count) return snapshot;
+  const Session& s = *sessions[index];
+
+  s.statsSeq.read([&] { memcpy(&snapshot, &s.stats, sizeof(snapshot)); });
+  return snapshot;
+}
+
+void NtripSessionManager::reconnect(uint8_t index) {
+  if (index < count) sessions[index]->reconnectRequested.store(true);
+}
+
+void NtripSessionManager::reset(uint8_t index) {
+  if (index < count) sessions[index]->resetRequested.store(true);
+}
+
+void NtripSessionManager::setLogger(NtripLogFn logger) {
+  logFn = logger;
+}
+
+void NtripSessionManager::logf(const Session& s, NtripLogLevel level, const char* fmt, ...) const {
+  if (logFn == nullptr || fmt == nullptr || (int)level > NTRIP_CLIENT_LOG_LEVEL) return;
+
+  char message[256];
+  int prefix = snprintf(message, sizeof(message), "[%u] ", s.index);
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(message + prefix, sizeof(message) - prefix, fmt, args);
+  va_end(args);
+
+  logFn(level, "NtripSession", message);
+}
+
+#endif // NTRIP_CLIENT_ENABLE_TASK
@@ -0,0 +1,202 @@
+#include "RtcmEpochTracker.h"
+
+static const uint8_t HISTORY = NTRIP_CLIENT_EPOCH_HISTORY;
+
+static_assert(NTRIP_CLIENT_EPOCH_HISTORY >= 2 && NTRIP_CLIENT_EPOCH_HISTORY <= 255,
+              "NTRIP_CLIENT_EPOCH_HISTORY must be 2..255");
+
+// Spacings beyond this are gaps, not intervals.
+static const uint32_t MAX_INTERVAL_MS = 60000;
+
+// True if `time` is at or past `due` on the circular ms-of-day scale.
+static bool isDue(uint32_t time, uint32_t due) {
+  return (time + RtcmEpochTracker::DAY_MS - due) % RtcmEpochTracker::DAY_MS <
+         RtcmEpochTracker::DAY_MS / 2;
+}
+
+void RtcmEpochTracker::reset() {
+  summary = RtcmEpochStats();
+  ringHead = 0;
+  ringCount = 0;
+  refGpsMs = 0;
+  refLocalMs = 0;
+  haveRef = false;
+  resetTiming();
+}
+
+void RtcmEpochTracker::resetTiming() {
+  memset(tracks, 0, sizeof(tracks));
+  current = RtcmEpochRecord();
+  open = false;
+  haveClose = false;
+  lastClose = 0;
+  lastCloseAt = 0;
+  lastCloseDelta = 0;
+  closeJitterHead = 0;
+  closeJitterCount = 0;
+}
+
+uint32_t RtcmEpochTracker::toGpsMsOfDay(RtcmGnss gnss, uint32_t epochTime) {
+  switch (gnss) {
+    case RtcmGnss::GLONASS: {
+      // Day of week in the top 3 bits, then ms of day in UTC(SU) = UTC + 3 h.
+      const uint32_t msOfDay = epochTime & ((1UL << 27) - 1);
+      return (msOfDay + DAY_MS - 3 * 3600000UL + NTRIP_CLIENT_GPS_LEAP_SECONDS * 1000UL) % DAY_MS;
+    }
+    case RtcmGnss::BEIDOU:
+      return (epochTime + 14000UL) % DAY_MS;  // BDT = GPST − 14 s
+    default:
+      return epochTime % DAY_MS;  // GPS, Galileo, QZSS, SBAS, NavIC: GPS-aligned TOW
+  }
+}
+
+bool RtcmEpochTracker::onFrame(uint16_t type, const uint8_t* header, size_t len,
+                               unsigned long nowMs) {
+  const RtcmGnss gnss = RtcmFrame::msmGnssOf(type);
+  if (gnss == RtcmGnss::NONE) return false;
+  const RtcmBitReader bits(header, len);
+  if (!bits.fits(0, RtcmFrame::MSM_MULTIPLE_POS + 1)) return false;
+
+  const uint32_t epoch = toGpsMsOfDay(gnss, (uint32_t)bits.getUnsigned(RtcmFrame::MSM_EPOCH_POS, 30));
+  const bool more = bits.getUnsigned(RtcmFrame::MSM_MULTIPLE_POS, 1) != 0;
+
+  // A straggler from the epoch that just closed must not open a new one.
+  if (!open && haveClose && epoch == lastClose) return false;
+
+  bool closed = false;
+  if (open && epoch != current.gpsMsOfDay) {
+    // New epoch time before the last MSM of the open one.
+    closeEpoch(false);
+    closed = true;
+  }
+  if (!open) {
+    current = RtcmEpochRecord();
+    current.gpsMsOfDay = epoch;
+    current.firstArrivalMs = nowMs;
+    open = true;
+  }
+
+  const uint8_t g = (uint8_t)gnss - 1;
+  tracks[g].frames++;
+  tracks[g].arrival = nowMs;
+  current.frames++;
+  current.lastArrivalMs = nowMs;
+  current.gnssMask |= 1 << g;
+
+  if (!more) {
+    closeEpoch(true);
+    closed = true;
+  }
+  return closed;
+}
+
+void RtcmEpochTracker::closeEpoch(bool sawLast) {
+  const uint32_t epoch = current.gpsMsOfDay;
+
+  for (uint8_t g = 0; g < RTCM_GNSS_COUNT; g++) {
+    Track& t = tracks[g];
+    RtcmGnssEpochStats& s = summary.gnss[g];
+
+    if (current.gnssMask & (1 << g)) {
+      if (t.seen) {
+        const uint32_t delta = (epoch + DAY_MS - t.lastEpoch) % DAY_MS;
+        learnInterval(delta, t.lastDelta, s.intervalMs);
+        const uint32_t spacing = t.arrival - t.lastArrival;
+        pushJitter(t.jitter, t.jitterHead, t.jitterCount,
+                   spacing > delta ? spacing - delta : delta - spacing,
+                   s.jitterMs, s.maxJitterMs);
+      }
+      t.seen = true;
+      t.lastEpoch = epoch;
+      t.lastArrival = t.arrival;
+      t.nextDue = (epoch + s.intervalMs) % DAY_MS;
+      s.epochs++;
+      s.frames = t.frames;
+      s.ageMs = ageAt(epoch, t.arrival);
+    } else if (t.seen && s.intervalMs > 0 && isDue(epoch, t.nextDue)) {
+      current.missingMask |= 1 << g;
+      s.missing++;
+      // Skip every slot already passed; one miss is counted per epoch.
+      while (isDue(epoch, t.nextDue)) t.nextDue = (t.nextDue + s.intervalMs) % DAY_MS;
+    }
+    t.frames = 0;
+  }
+
+  current.complete = sawLast && current.missingMask == 0;
+  if (current.complete) summary.complete++;
+  else summary.incomplete++;
+
+  if (haveClose) {
+    const uint32_t delta = (epoch + DAY_MS - lastClose) % DAY_MS;
+    learnInterval(delta, lastCloseDelta, summary.intervalMs);
+    const uint32_t spacing = current.lastArrivalMs - lastCloseAt;
+    pushJitter(closeJitter, closeJitterHead, closeJitterCount,
+               spacing > delta ? spacing - delta : delta - spacing,
+               summary.jitterMs, summary.maxJitterMs);
+  }
+  haveClose = true;
+  lastClose = epoch;
+  lastCloseAt = current.lastArrivalMs;
+  summary.lastEpochMs = epoch;
+  summary.ageMs = ageAt(epoch, current.lastArrivalMs);
+
+  ring[ringHead] = current;
+  ringHead = (uint8_t)((ringHead + 1) % HISTORY);
+  if (ringCount < HISTORY) ringCount++;
+  open = false;
+}
+
+void RtcmEpochTracker::learnInterval(uint32_t delta, uint32_t& lastDelta, uint32_t& interval) {
+  // Adopt the first spacing, then only a spacing seen twice in a row, so a
+  // single dropped epoch does not double the interval.
+  if (delta == 0 || delta > MAX_INTERVAL_MS) return;
+  if (interval == 0 || delta == lastDelta) interval = delta;
+  lastDelta = delta;
+}
+
+void RtcmEpochTracker::pushJitter(uint16_t* jitterRing, uint8_t& head, uint8_t& count,
+                                  uint32_t value, uint32_t& mean, uint32_t& max) {
+  jitterRing[head] = (uint16_t)min<uint32_t>(value, 0xFFFF);
+  head = (uint8_t)((head + 1) % HISTORY);
+  if (count < HISTORY) count++;
+
+  uint32_t sum = 0;
+  max = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    sum += jitterRing[i];
+    if (jitterRing[i] > max) max = jitterRing[i];
+  }
+  mean = sum / count;
+}
+
+void RtcmEpochTracker::setTimeReference(uint32_t gpsMsOfDay, unsigned long localMs) {
+  refGpsMs = gpsMsOfDay % DAY_MS;
+  refLocalMs = (uint32_t)localMs;
+  haveRef = true;
+}
+
+int32_t RtcmEpochTracker::ageAt(uint32_t gpsMsOfDay, uint32_t localMs) const {
+  if (!haveRef) return -1;
+  const int32_t elapsed = (int32_t)(localMs - refLocalMs);
+  if (elapsed > (int32_t)REFERENCE_MAX_AGE_MS || elapsed < -(int32_t)REFERENCE_MAX_AGE_MS) return -1;
+
+  const uint32_t now = (uint32_t)((int64_t)refGpsMs + DAY_MS + elapsed) % DAY_MS;
+  const uint32_t age = (now + DAY_MS - gpsMsOfDay) % DAY_MS;
+  // An epoch "from the future" means the reference lags; report it negative.
+  return age > DAY_MS / 2 ? (int32_t)age - (int32_t)DAY_MS : (int32_t)age;
+}
+
+unsigned long RtcmEpochTracker::sinceLastEpoch(unsigned long nowMs) const {
+  return haveClose ? nowMs - lastCloseAt : 0;
+}
+
+size_t RtcmEpochTracker::history(RtcmEpochRecord* out, size_t max) const {
+  const size_t n = min<size_t>(max, ringCount);
+  // Newest n records, oldest first.
+  size_t idx = (ringHead + HISTORY - n) % HISTORY;
+  for (size_t i = 0; i < n; i++) {
+    out[i] = ring[idx];
+    idx = (idx + 1) % HISTORY;
+  }
+  return n;
+}
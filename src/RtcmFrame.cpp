@@ -0,0 +1,83 @@
+#include "RtcmFrame.h"
+#include "RtcmParser.h"
+
+RtcmFrame::RtcmFrame(const uint8_t* frame, size_t len)
+    : reader(frame + 3, len >= RtcmParser::FRAME_OVERHEAD ? len - RtcmParser::FRAME_OVERHEAD : 0) {}
+
+bool RtcmFrame::hasStationId(uint16_t type) {
+  return (type >= 1001 && type <= 1013) || type == 1033 || type == 1230 || msmLevelOf(type) != 0;
+}
+
+bool RtcmFrame::stationId(uint16_t& out) const {
+  if (!hasStationId(messageType()) || !reader.fits(12, 12)) return false;
+  out = (uint16_t)reader.getUnsigned(12, 12);
+  return true;
+}
+
+// ─── 1005 / 1006 ────────────────────────────────────────────────────────────
+
+bool RtcmFrame::stationArp(RtcmStationArp& out) const {
+  const uint16_t type = messageType();
+  if (type != 1005 && type != 1006) return false;
+  if (!reader.fits(0, type == 1006 ? 168 : 152)) return false;
+
+  out.stationId = (uint16_t)reader.getUnsigned(12, 12);
+  out.itrfYear = (uint8_t)reader.getUnsigned(24, 6);
+  out.gps = reader.getUnsigned(30, 1) != 0;
+  out.glonass = reader.getUnsigned(31, 1) != 0;
+  out.galileo = reader.getUnsigned(32, 1) != 0;
+  out.referenceStation = reader.getUnsigned(33, 1) != 0;
+  out.ecefX = reader.getSigned(34, 38);
+  out.ecefY = reader.getSigned(74, 38);   // After oscillator + reserved bits
+  out.ecefZ = reader.getSigned(114, 38);  // After quarter-cycle indicator
+  out.antennaHeight = type == 1006 ? (uint16_t)reader.getUnsigned(152, 16) : 0;
+  return true;
+}
+
+// ─── MSM ────────────────────────────────────────────────────────────────────
+// Types 1071..1077 (GPS) through 1131..1137 (NavIC), one block of ten per
+// constellation; the last digit is the MSM level.
+
+RtcmGnss RtcmFrame::msmGnssOf(uint16_t type) {
+  if (msmLevelOf(type) == 0) return RtcmGnss::NONE;
+  return (RtcmGnss)((type - 1070) / 10 + (uint8_t)RtcmGnss::GPS);
+}
+
+uint8_t RtcmFrame::msmLevelOf(uint16_t type) {
+  if (type < 1071 || type > 1137) return 0;
+  const uint8_t level = type % 10;
+  return level >= 1 && level <= 7 ? level : 0;
+}
+
+bool RtcmFrame::msmEpochTime(uint32_t& out) const {
+  if (!isMsm() || !reader.fits(MSM_EPOCH_POS, 30)) return false;
+  out = (uint32_t)reader.getUnsigned(MSM_EPOCH_POS, 30);
+  return true;
+}
+
+bool RtcmFrame::msmCounts(uint8_t& satellites, uint8_t& signals) const {
+  if (!isMsm() || !reader.fits(MSM_SAT_MASK_POS, 96)) return false;
+  satellites = (uint8_t)__builtin_popcountll(reader.getUnsigned(MSM_SAT_MASK_POS, 64));
+  signals = (uint8_t)__builtin_popcount((uint32_t)reader.getUnsigned(MSM_SIG_MASK_POS, 32));
+  return true;
+}
+
+bool RtcmFrame::msmHeader(RtcmMsmHeader& out) const {
+  if (!isMsm() || !reader.fits(0, MSM_CELL_MASK_POS)) return false;
+
+  out.stationId = (uint16_t)reader.getUnsigned(12, 12);
+  out.epochTime = (uint32_t)reader.getUnsigned(MSM_EPOCH_POS, 30);
+  out.multipleMessage = reader.getUnsigned(MSM_MULTIPLE_POS, 1) != 0;
+  out.iods = (uint8_t)reader.getUnsigned(55, 3);
+  out.satelliteMask = reader.getUnsigned(MSM_SAT_MASK_POS, 64);
+  out.signalMask = (uint32_t)reader.getUnsigned(MSM_SIG_MASK_POS, 32);
+  out.satellites = (uint8_t)__builtin_popcountll(out.satelliteMask);
+  out.signals = (uint8_t)__builtin_popcount(out.signalMask);
+
+  // The cell mask is at most 64 bits; larger products are invalid MSM.
+  const uint16_t cellBits = (uint16_t)out.satellites * out.signals;
+  if (cellBits > 64 || !reader.fits(MSM_CELL_MASK_POS, (uint8_t)cellBits)) return false;
+  out.cellMask = reader.getUnsigned(MSM_CELL_MASK_POS, (uint8_t)cellBits);
+  out.cells = (uint8_t)__builtin_popcountll(out.cellMask);
+  return true;
+}
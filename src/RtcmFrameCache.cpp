@@ -0,0 +1,124 @@
+#include "RtcmFrameCache.h"
+#include "RtcmBitReader.h"
+#include "RtcmParser.h"
+
+static constexpr size_t RECORD_BYTES = 12;
+
+static bool isStationBound(uint16_t type) {
+  return type == 1005 || type == 1006 || type == 1007 || type == 1008 ||
+         type == 1033 || type == 1230;
+}
+
+// Width of the satellite ID that follows the message type, 0 if not ephemeris.
+static uint8_t ephemerisSatBits(uint16_t type) {
+  switch (type) {
+    case 1019: case 1020: case 1041: case 1042: case 1045: case 1046: return 6;
+    case 1044: return 4;
+    default: return 0;
+  }
+}
+
+void RtcmFrameCache::begin(uint8_t* storage, size_t cap) {
+  pool = cap > 0 ? storage : nullptr;
+  capacity = pool != nullptr ? cap : 0;
+  clear();
+}
+
+bool RtcmFrameCache::isCacheable(uint16_t type) {
+  return isStationBound(type) || ephemerisSatBits(type) != 0;
+}
+
+void RtcmFrameCache::removeAt(size_t offset, size_t bytes) {
+  memmove(pool + offset, pool + offset + bytes, used - offset - bytes);
+  used -= bytes;
+  count--;
+}
+
+bool RtcmFrameCache::store(const uint8_t* frame, size_t len, unsigned long nowMs) {
+  if (pool == nullptr || len <= RtcmParser::FRAME_OVERHEAD) return false;
+  const RtcmBitReader bits(frame + 3, len - RtcmParser::FRAME_OVERHEAD);
+  if (!bits.fits(0, 24)) return false;
+
+  static_assert(sizeof(Record) == RECORD_BYTES, "Record layout changed");
+  Record rec;
+  rec.type = (uint16_t)bits.getUnsigned(0, 12);
+  const uint8_t satBits = ephemerisSatBits(rec.type);
+  if (!isStationBound(rec.type) && satBits == 0) return false;
+  rec.station = satBits == 0 ? (uint16_t)bits.getUnsigned(12, 12) : NO_STATION;
+  rec.satellite = satBits != 0 ? (uint8_t)bits.getUnsigned(12, satBits) : 0;
+  rec.reserved = 0;
+  rec.length = (uint16_t)len;
+  rec.storedAt = (uint32_t)nowMs;
+
+  const size_t bytes = RECORD_BYTES + len;
+  if (bytes > capacity) return false;
+
+  // Drop the previous copy of this key.
+  for (size_t off = 0; off < used;) {
+    Record old;
+    memcpy(&old, pool + off, RECORD_BYTES);
+    const size_t oldBytes = RECORD_BYTES + old.length;
+    if (old.type == rec.type && old.satellite == rec.satellite) {
+      removeAt(off, oldBytes);
+      break;
+    }
+    off += oldBytes;
+  }
+
+  // Evict from the front (least recently updated) until it fits.
+  while (used + bytes > capacity) {
+    Record oldest;
+    memcpy(&oldest, pool, RECORD_BYTES);
+    removeAt(0, RECORD_BYTES + oldest.length);
+  }
+
+  memcpy(pool + used, &rec, RECORD_BYTES);
+  memcpy(pool + used + RECORD_BYTES, frame, len);
+  used += bytes;
+  count++;
+  return true;
+}
+
+size_t RtcmFrameCache::exportStation(uint8_t* out, size_t cap) const {
+  size_t written = 0;
+  for (size_t off = 0; off < used;) {
+    Record rec;
+    memcpy(&rec, pool + off, RECORD_BYTES);
+    if (rec.station != NO_STATION && written + rec.length <= cap) {
+      memcpy(out + written, pool + off + RECORD_BYTES, rec.length);
+      written += rec.length;
+    }
+    off += RECORD_BYTES + rec.length;
+  }
+  return written;
+}
+
+size_t RtcmFrameCache::restore(const uint8_t* frames, size_t len, unsigned long nowMs) {
+  size_t stored = 0;
+  for (size_t off = 0; off + RtcmParser::FRAME_OVERHEAD <= len;) {
+    if (frames[off] != 0xD3) break;
+    const size_t frameLen = (((size_t)frames[off + 1] & 0x03) << 8 | frames[off + 2]) +
+                            RtcmParser::FRAME_OVERHEAD;
+    if (off + frameLen > len) break;
+    if (store(frames + off, frameLen, nowMs)) stored++;
+    off += frameLen;
+  }
+  return stored;
+}
+
+size_t RtcmFrameCache::replay(WriteFn write, void* ctx, uint16_t stationId, uint32_t maxAgeMs,
+                              unsigned long nowMs) const {
+  size_t written = 0;
+  for (size_t off = 0; off < used;) {
+    Record rec;
+    memcpy(&rec, pool + off, RECORD_BYTES);
+    const bool stationOk = rec.station == NO_STATION || rec.station == stationId;
+    const bool fresh = maxAgeMs == 0 || (uint32_t)nowMs - rec.storedAt <= maxAgeMs;
+    if (stationOk && fresh) {
+      write(pool + off + RECORD_BYTES, rec.length, ctx);
+      written++;
+    }
+    off += RECORD_BYTES + rec.length;
+  }
+  return written;
+}
@@ -0,0 +1,108 @@
+#include "RtcmHealthModel.h"
+#include <math.h>
+
+static_assert(NTRIP_CLIENT_HEALTH_TYPES >= 1 && NTRIP_CLIENT_HEALTH_TYPES <= 255,
+              "NTRIP_CLIENT_HEALTH_TYPES must be 1..255");
+
+// EWMA gains for the interval and its variance (as in TCP RTO estimation).
+static const float MEAN_GAIN = 0.125f;
+static const float VAR_GAIN = 0.25f;
+
+// Same-type frames closer than this before an interval is known are one burst.
+static const uint32_t MIN_INTERVAL_MS = 20;
+
+void RtcmHealthModel::configure(uint8_t sigmaK, uint32_t floor, uint32_t ceiling) {
+  k = sigmaK;
+  floorMs = floor;
+  ceilingMs = ceiling;
+}
+
+void RtcmHealthModel::reset() {
+  memset(slots, 0, sizeof(slots));
+  limit = 0;
+}
+
+RtcmHealthModel::Slot* RtcmHealthModel::slotFor(uint16_t type, uint32_t nowMs) {
+  Slot* oldest = &slots[0];
+  for (uint8_t i = 0; i < NTRIP_CLIENT_HEALTH_TYPES; i++) {
+    Slot& s = slots[i];
+    if (s.used && s.type == type) return &s;
+    if (!s.used) {
+      oldest = &s;
+    } else if (oldest->used && nowMs - s.last > nowMs - oldest->last) {
+      oldest = &s;
+    }
+  }
+  memset(oldest, 0, sizeof(*oldest));
+  oldest->type = type;
+  oldest->last = nowMs;
+  oldest->used = true;
+  return nullptr;  // First sighting: nothing to measure yet
+}
+
+void RtcmHealthModel::update(Slot& s, uint32_t deltaMs) {
+  const float d = (float)deltaMs;
+  if (s.samples == 0) {
+    s.mean = d;
+    s.var = 0;
+  } else {
+    const float err = d - s.mean;
+    s.mean += MEAN_GAIN * err;
+    s.var = (1 - VAR_GAIN) * (s.var + VAR_GAIN * err * err);
+  }
+  if (s.samples < 0xFFFF) s.samples++;
+
+  const float tolerance = s.mean + k * sqrtf(s.var);
+  s.tolerance = (uint32_t)min<float>(max<float>(tolerance, (float)floorMs), (float)ceilingMs);
+  s.trusted = s.samples >= NTRIP_CLIENT_HEALTH_MIN_SAMPLES;
+}
+
+void RtcmHealthModel::onFrame(uint16_t type, unsigned long now) {
+  const uint32_t nowMs = (uint32_t)now;
+  Slot* s = slotFor(type, nowMs);
+  if (s != nullptr) {
+    const uint32_t delta = nowMs - s->last;
+    const uint32_t burst = s->samples > 0 ? (uint32_t)(s->mean / 4) : MIN_INTERVAL_MS;
+    if (s->restart || delta >= ceilingMs) {
+      // Back after being dropped, or after a gap longer than the fixed
+      // timeout: that gap says nothing about the rate.
+      s->samples = 0;
+      s->trusted = false;
+      s->restart = false;
+      s->last = nowMs;
+    } else if (delta >= burst) {
+      update(*s, delta);
+      s->last = nowMs;
+    }
+  }
+
+  // Drop types that are overdue while this frame still arrived, and take
+  // the tightest tolerance of the rest.
+  limit = 0;
+  for (uint8_t i = 0; i < NTRIP_CLIENT_HEALTH_TYPES; i++) {
+    Slot& t = slots[i];
+    if (!t.trusted) continue;
+    if (nowMs - t.last > t.tolerance) {
+      t.trusted = false;
+      t.restart = true;
+      continue;
+    }
+    if (limit == 0 || t.tolerance < limit) limit = t.tolerance;
+  }
+}
+
+size_t RtcmHealthModel::types(RtcmHealthTypeStats* out, size_t max) const {
+  size_t n = 0;
+  for (uint8_t i = 0; i < NTRIP_CLIENT_HEALTH_TYPES && n < max; i++) {
+    const Slot& s = slots[i];
+    if (!s.used) continue;
+    RtcmHealthTypeStats& o = out[n++];
+    o.messageType = s.type;
+    o.samples = s.samples;
+    o.meanMs = (uint32_t)s.mean;
+    o.sigmaMs = (uint32_t)sqrtf(s.var);
+    o.toleranceMs = s.tolerance;
+    o.trusted = s.trusted;
+  }
+  return n;
+}
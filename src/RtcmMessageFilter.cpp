@@ -0,0 +1,100 @@
+#include "RtcmMessageFilter.h"
+
+constexpr uint16_t RtcmMessageFilter::TYPE_COUNT;
+constexpr uint16_t RtcmMessageFilter::WORDS;
+
+RtcmMessageFilter::RtcmMessageFilter() {
+  memset(denied, 0, sizeof(denied));
+  memset(decimated, 0, sizeof(decimated));
+}
+
+void RtcmMessageFilter::allowAll() {
+  memset(denied, 0, sizeof(denied));
+  updateActive();
+}
+
+void RtcmMessageFilter::denyAll() {
+  memset(denied, 0xFF, sizeof(denied));
+  updateActive();
+}
+
+void RtcmMessageFilter::allow(uint16_t type) {
+  allow(type, type);
+}
+
+void RtcmMessageFilter::allow(uint16_t first, uint16_t last) {
+  // Clear deny bits for [first, last].
+  for (uint32_t t = first; t <= last && t < TYPE_COUNT; t++) {
+    denied[t >> 5] &= ~(1UL << (t & 31));
+  }
+  updateActive();
+}
+
+void RtcmMessageFilter::deny(uint16_t type) {
+  deny(type, type);
+}
+
+void RtcmMessageFilter::deny(uint16_t first, uint16_t last) {
+  // Set deny bits for [first, last].
+  for (uint32_t t = first; t <= last && t < TYPE_COUNT; t++) {
+    denied[t >> 5] |= 1UL << (t & 31);
+  }
+  updateActive();
+}
+
+bool RtcmMessageFilter::setInterval(uint16_t type, uint32_t intervalMs) {
+  if (type >= TYPE_COUNT) return false;
+  const uint32_t bit = 1UL << (type & 31);
+
+  for (uint8_t i = 0; i < slotCount; i++) {
+    if (slots[i].type != type) continue;
+    if (intervalMs == 0) {
+      // Remove slot: move last entry into its place.
+      slots[i] = slots[--slotCount];
+      decimated[type >> 5] &= ~bit;
+    } else {
+      slots[i].intervalMs = intervalMs;
+    }
+    updateActive();
+    return true;
+  }
+
+  if (intervalMs == 0) return true;
+  if (slotCount >= NTRIP_CLIENT_MAX_DECIMATED_TYPES) return false;
+
+  Slot& slot = slots[slotCount++];
+  slot.type = type;
+  slot.seen = false;
+  slot.intervalMs = intervalMs;
+  slot.lastForwarded = 0;
+  decimated[type >> 5] |= bit;
+  updateActive();
+  return true;
+}
+
+void RtcmMessageFilter::resetTiming() {
+  for (uint8_t i = 0; i < slotCount; i++) {
+    slots[i].seen = false;
+  }
+}
+
+bool RtcmMessageFilter::acceptDecimated(uint16_t type, unsigned long nowMs) {
+  // Bounded scan over at most NTRIP_CLIENT_MAX_DECIMATED_TYPES slots.
+  for (uint8_t i = 0; i < slotCount; i++) {
+    Slot& slot = slots[i];
+    if (slot.type != type) continue;
+    if (slot.seen && nowMs - slot.lastForwarded < slot.intervalMs) return false;
+    slot.seen = true;
+    slot.lastForwarded = nowMs;
+    return true;
+  }
+  return true;
+}
+
+void RtcmMessageFilter::updateActive() {
+  // Recomputed on configuration changes only, never per frame.
+  active = slotCount > 0;
+  for (uint16_t i = 0; i < WORDS && !active; i++) {
+    if (denied[i] != 0) active = true;
+  }
+}
@@ -1,14 +1,88 @@
 #include "RtcmParser.h"
 
+constexpr size_t RtcmParser::FRAME_OVERHEAD;
+constexpr size_t RtcmParser::MAX_FRAME_SIZE;
+
 // CRC24Q polynomial used by RTCM 3.x.
 static constexpr uint32_t CRC24Q_POLY = 0x1864CFB;
 
+#if NTRIP_CLIENT_CRC24Q_BACKEND != NTRIP_CLIENT_CRC24Q_BITWISE
+
+// Table generation is done at compile time with C++11-compatible constexpr
+// recursion, so the tables land in flash (.rodata) with no startup cost.
+// Entry k of table n is the CRC of byte k followed by n zero bytes, which is
+// simply 8·(n+1) bitwise steps starting from k << 16.
+
+static constexpr uint32_t crcStep(uint32_t c) {
+  return (c & 0x800000) ? ((c << 1) ^ CRC24Q_POLY) : (c << 1);
+}
+
+static constexpr uint32_t crcSteps(uint32_t c, int n) {
+  return n == 0 ? (c & 0xFFFFFF) : crcSteps(crcStep(c) & 0xFFFFFF, n - 1);
+}
+
+#define CRC24Q_E1(t, i)   crcSteps((uint32_t)(i) << 16, 8 * ((t) + 1))
+#define CRC24Q_E4(t, i)   CRC24Q_E1(t, i), CRC24Q_E1(t, (i) + 1), \
+                          CRC24Q_E1(t, (i) + 2), CRC24Q_E1(t, (i) + 3)
+#define CRC24Q_E16(t, i)  CRC24Q_E4(t, i), CRC24Q_E4(t, (i) + 4), \
+                          CRC24Q_E4(t, (i) + 8), CRC24Q_E4(t, (i) + 12)
+#define CRC24Q_E64(t, i)  CRC24Q_E16(t, i), CRC24Q_E16(t, (i) + 16), \
+                          CRC24Q_E16(t, (i) + 32), CRC24Q_E16(t, (i) + 48)
+#define CRC24Q_E256(t)    CRC24Q_E64(t, 0), CRC24Q_E64(t, 64), \
+                          CRC24Q_E64(t, 128), CRC24Q_E64(t, 192)
+
+#if NTRIP_CLIENT_CRC24Q_BACKEND == NTRIP_CLIENT_CRC24Q_SLICE4
+static constexpr uint32_t CRC24Q_TABLE[4][256] = {
+  { CRC24Q_E256(0) }, { CRC24Q_E256(1) }, { CRC24Q_E256(2) }, { CRC24Q_E256(3) }
+};
+#define CRC24Q_T0 CRC24Q_TABLE[0]
+#else
+static constexpr uint32_t CRC24Q_TABLE[256] = { CRC24Q_E256(0) };
+#define CRC24Q_T0 CRC24Q_TABLE
+#endif
+
+#undef CRC24Q_E1
+#undef CRC24Q_E4
+#undef CRC24Q_E16
+#undef CRC24Q_E64
+#undef CRC24Q_E256
+
+#endif // NTRIP_CLIENT_CRC24Q_BACKEND != NTRIP_CLIENT_CRC24Q_BITWISE
+
 uint32_t RtcmParser::crc24q(uint32_t crc, uint8_t byte) {
+#if NTRIP_CLIENT_CRC24Q_BACKEND == NTRIP_CLIENT_CRC24Q_BITWISE
   // Bitwise CRC update for a single byte.
   crc ^= (uint32_t)byte << 16;
   for (int i = 0; i < 8; i++)
     crc = (crc & 0x800000) ? (crc << 1) ^ CRC24Q_POLY : (crc << 1);
   return crc & 0xFFFFFF;
+#else
+  // Table-driven update: one lookup per byte.
+  return ((crc << 8) ^ CRC24Q_T0[((crc >> 16) ^ byte) & 0xFF]) & 0xFFFFFF;
+#endif
+}
+
+uint32_t RtcmParser::crc24q(uint32_t crc, const uint8_t* data, size_t len) {
+#if NTRIP_CLIENT_CRC24Q_BACKEND == NTRIP_CLIENT_CRC24Q_SLICE4
+  // Slice-by-4: fold the 24-bit register into the next three bytes and
+  // resolve four bytes with four independent lookups.
+  while (len >= 4) {
+    crc = CRC24Q_TABLE[3][((crc >> 16) ^ data[0]) & 0xFF] ^
+          CRC24Q_TABLE[2][((crc >> 8)  ^ data[1]) & 0xFF] ^
+          CRC24Q_TABLE[1][( crc        ^ data[2]) & 0xFF] ^
+          CRC24Q_TABLE[0][data[3]];
+    data += 4;
+    len -= 4;
+  }
+#endif
+  while (len--) {
+    crc = crc24q(crc, *data++);
+  }
+  return crc;
+}
+
+uint32_t RtcmParser::crc24q(const uint8_t* data, size_t len) {
+  return crc24q((uint32_t)0, data, len);
 }
 
 uint16_t RtcmParser::extractMessageType() {
@@ -50,7 +124,7 @@ RtcmResult RtcmParser::feed(uint8_t b) {
       length |= b;
       crc = crc24q(crc, b);
       index = 0;
-      state = PAYLOAD;
+      state = length > 0 ? PAYLOAD : CRC;
       break;
       
     case PAYLOAD:
@@ -92,6 +166,41 @@ RtcmResult RtcmParser::feed(uint8_t b) {
   return result;
 }
 
+size_t RtcmParser::feed(const uint8_t* data, size_t len,
+                        RtcmFrameFn onFrame, void* ctx) {
+  // Bulk variant of feed(uint8_t): SYNC and PAYLOAD spans are consumed in
+  // one step; the short header/CRC states reuse the per-byte state machine.
+  size_t i = 0;
+  while (i < len) {
+    if (state == SYNC) {
+      const void* p = memchr(data + i, 0xD3, len - i);
+      if (p == nullptr) return len;
+      i = (size_t)((const uint8_t*)p - data);
+    } else if (state == PAYLOAD) {
+      size_t take = min(len - i, (size_t)(length - index));
+      if (index < sizeof(payloadBuf)) {
+        size_t keep = min(take, sizeof(payloadBuf) - index);
+        memcpy(payloadBuf + index, data + i, keep);
+      }
+      crc = crc24q(crc, data + i, take);
+      index += take;
+      i += take;
+      if (index >= length) {
+        state = CRC;
+        index = 0;
+      }
+      continue;
+    }
+
+    RtcmResult result = feed(data[i++]);
+    if ((result.valid || result.crcError) && onFrame != nullptr &&
+        !onFrame(result, i, ctx)) {
+      return i;
+    }
+  }
+  return len;
+}
+
 void RtcmParser::reset() {
   // Reset parser state for next frame.
   state = SYNC;
@@ -100,6 +209,18 @@ void RtcmParser::reset() {
   crc = 0;
 }
 
+size_t RtcmParser::pendingBytes() const {
+  // Preamble + length bytes + payload/CRC progress.
+  switch (state) {
+    case SYNC: return 0;
+    case LEN1: return 1;
+    case LEN2: return 2;
+    case PAYLOAD: return 3 + index;
+    case CRC: return 3 + length + index;
+    default: return 0;
+  }
+}
+
 const char* RtcmParser::getStateName() const {
   // Human-readable state name for debugging.
   switch (state) {
@@ -0,0 +1,51 @@
+#include "SpscRingBuffer.h"
+
+bool SpscRingBuffer::begin(uint8_t* storage, size_t capacity) {
+  if (storage == nullptr || !isPowerOfTwo(capacity)) return false;
+  buf = storage;
+  cap = capacity;
+  mask = capacity - 1;
+  clear();
+  return true;
+}
+
+bool SpscRingBuffer::push(const uint8_t* data, size_t len) {
+  // Producer owns head; tail is read with acquire to see freed space.
+  const size_t h = head.load(std::memory_order_relaxed);
+  const size_t t = tail.load(std::memory_order_acquire);
+  if (len > cap - (h - t)) return false;
+
+  // Copy in at most two pieces (up to the end, then from the start).
+  const size_t pos = h & mask;
+  const size_t first = min(len, cap - pos);
+  memcpy(buf + pos, data, first);
+  memcpy(buf, data + first, len - first);
+
+  head.store(h + len, std::memory_order_release);
+  return true;
+}
+
+size_t SpscRingBuffer::peek(const uint8_t*& data) const {
+  // Consumer owns tail; head is read with acquire to see published bytes.
+  const size_t t = tail.load(std::memory_order_relaxed);
+  const size_t h = head.load(std::memory_order_acquire);
+  const size_t pos = t & mask;
+  data = buf + pos;
+  return min(h - t, cap - pos);
+}
+
+void SpscRingBuffer::consume(size_t len) {
+  tail.store(tail.load(std::memory_order_relaxed) + len,
+             std::memory_order_release);
+}
+
+size_t SpscRingBuffer::size() const {
+  // Load tail first so a concurrent consume() can never make it pass head.
+  const size_t t = tail.load(std::memory_order_acquire);
+  return head.load(std::memory_order_acquire) - t;
+}
+
+void SpscRingBuffer::clear() {
+  head.store(0, std::memory_order_relaxed);
+  tail.store(0, std::memory_order_relaxed);
+}